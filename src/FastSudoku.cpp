@@ -2,8 +2,17 @@
 
 #include "FastSudoku.h"
 #include "SudokuHeader.h"
+#include "SudokuCache.h"
+#include "SudokuSat.h"
+#include "SudokuAnnealer.h"
+#include <cassert>
 #include <iostream>
+#include <algorithm>
 #include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
 
 namespace YYYCZ {
 	/// <summary>
@@ -12,8 +21,8 @@ namespace YYYCZ {
 	/// <returns>if is init</returns>
 	inline bool FastSudoku::__CheckIfInit() const
 	{
-		return !(formDim == 0 || formLength == 0 || formSize == 0 ||
-			formDim * formDim != formLength || formLength * formLength != formSize ||
+		return !(!geometry || formLength == 0 || formSize == 0 ||
+			geometry->getLength() != formLength || formLength * formLength != formSize ||
 			form.empty() || form.size() != formSize);
 	}
 
@@ -29,9 +38,11 @@ namespace YYYCZ {
 			if (markChange) this->changePlace.insert(op.p2);
 			form[op.p2] = op.p1;
 			++finishCount;
+			countNumber(op.p1, op.p2, 1);
 			break;
 		case eraseMapper:
 			mapper[op.p2].erase(op.p1);
+			candidateMask[op.p2] &= ~bitOf(op.p1);
 			break;
 		case moveRank:
 			rank[op.p1 - 1].insert(op.p2);
@@ -41,6 +52,20 @@ namespace YYYCZ {
 			rank[0].insert(op.p2);
 			rank[op.p1].erase(op.p2);
 			break;
+		case removeForm:
+			if (markChange) this->changePlace.insert(op.p2);
+			form[op.p2] = 0;
+			--finishCount;
+			countNumber(op.p1, op.p2, -1);
+			break;
+		case restoreMapper:
+			mapper[op.p2].insert(op.p1);
+			candidateMask[op.p2] |= bitOf(op.p1);
+			break;
+		case raiseRank:
+			rank[op.p1 + 1].insert(op.p2);
+			rank[op.p1].erase(op.p2);
+			break;
 		}
 		if (recordMode)
 			records.push_back(op);
@@ -58,9 +83,11 @@ namespace YYYCZ {
 			if (markChange) this->changePlace.insert(op.p2);
 			form[op.p2] = 0;
 			--finishCount;
+			countNumber(op.p1, op.p2, -1);
 			break;
 		case eraseMapper:
 			mapper[op.p2].insert(op.p1);
+			candidateMask[op.p2] |= bitOf(op.p1);
 			break;
 		case moveRank:
 			rank[op.p1].insert(op.p2);
@@ -70,10 +97,56 @@ namespace YYYCZ {
 			rank[op.p1].insert(op.p2);
 			rank[0].erase(op.p2);
 			break;
+		case removeForm:
+			if (markChange) this->changePlace.insert(op.p2);
+			form[op.p2] = op.p1;
+			++finishCount;
+			countNumber(op.p1, op.p2, 1);
+			break;
+		case restoreMapper:
+			mapper[op.p2].erase(op.p1);
+			candidateMask[op.p2] &= ~bitOf(op.p1);
+			break;
+		case raiseRank:
+			rank[op.p1].insert(op.p2);
+			rank[op.p1 + 1].erase(op.p2);
+			break;
 		}
 		records.pop_back();
 	}
 
+	/// <summary>
+	/// count the number in the row, column and block of the place
+	/// </summary>
+	/// <param name="number">number</param>
+	/// <param name="index">index of place</param>
+	/// <param name="delta">1 when put, -1 when remove</param>
+	inline void FastSudoku::countNumber(save_t number, index_t index, int delta)
+	{
+		const index_t stride = formLength + 1;
+		const index_t row = index / formLength, column = index % formLength;
+		const index_t units[3] = { row, formLength + column, 2 * formLength + blockTable[index] };
+		for (auto unit : units) {
+			unitCounter[unit * stride + number] += delta;
+			if (delta > 0) unitHolder[unit * stride + number] = index;
+		}
+	}
+
+	/// <summary>
+	/// judge if the number is not in the row, column and block of the place
+	/// </summary>
+	/// <param name="number">number</param>
+	/// <param name="index">index of place</param>
+	/// <returns>if the number is free</returns>
+	inline bool FastSudoku::isNumberFree(save_t number, index_t index) const
+	{
+		const index_t stride = formLength + 1;
+		const index_t row = index / formLength, column = index % formLength;
+		return unitCounter[row * stride + number] == 0
+			&& unitCounter[(formLength + column) * stride + number] == 0
+			&& unitCounter[(2 * formLength + blockTable[index]) * stride + number] == 0;
+	}
+
 	/// <summary>
 	/// get the coordinate to the index
 	/// </summary>
@@ -113,7 +186,7 @@ namespace YYYCZ {
 	/// <returns>which block</returns>
 	inline FastSudoku::save_t FastSudoku::getBlock(save_t i, save_t j) const
 	{
-		return formDim * (i / formDim) + (j / formDim);
+		return (save_t)blockTable[i * formLength + j];
 	}
 
 	/// <summary>
@@ -134,8 +207,19 @@ namespace YYYCZ {
 	/// <returns>coordinate</returns>
 	inline std::pair<FastSudoku::save_t, FastSudoku::save_t> FastSudoku::blockAt(save_t block, save_t i) const
 	{
-		return std::pair<save_t, save_t>(formDim * (block / formDim) + i / formDim,
-			formDim * (block % formDim) + i % formDim);
+		return translate(placeTable[block * formLength + i]);
+	}
+
+	/// <summary>
+	/// get the blocks of the form of the size
+	/// </summary>
+	/// <param name="size">the size of the form</param>
+	/// <param name="preferred">the layout wanted, the standard boxes if null or not of the size</param>
+	/// <returns>the layout, null if no sudoku of the size</returns>
+	std::shared_ptr<const SudokuGeometry> FastSudoku::geometryOf(size_t size, const std::shared_ptr<const SudokuGeometry>& preferred) const
+	{
+		if (preferred && preferred->getSize() == size) return preferred;
+		return SudokuGeometry::standard(size);
 	}
 
 	/// <summary>
@@ -148,6 +232,7 @@ namespace YYYCZ {
 	bool FastSudoku::__eraseLocalNumber(save_t k, save_t number, std::function<index_t(save_t, save_t)> translator)
 	{
 		SudokuOperate op1{ eraseMapper, number, 0 }, op2{ moveRank, 0, 0 };
+		bool ok = true;
 		for (save_t i = 0; i < formLength; ++i) {
 			index_t index = translator(k, i);
 			if (mapper[index].find(number) != mapper[index].end()) {
@@ -157,13 +242,15 @@ namespace YYYCZ {
 				doOperate(op1);
 				doOperate(op2);
 
-				// check empty if ok
+				// check empty if ok, the search gives up at once and undoes,
+				// but without recording (play and init) all peers are erased, so the candidates stay exact
 				if (mapper[index].empty() && form[index] == 0) {
-					return false;
+					if (recordMode) return false;
+					ok = false;
 				}
 			}
 		}
-		return true;
+		return ok;
 	}
 
 	/// <summary>
@@ -230,10 +317,11 @@ namespace YYYCZ {
 		auto coor = translate(index);
 		auto block = getBlock(coor);
 		eraseAllNumberOfOnePlace(index);
-		if (!eraseRowNumber(coor.first, number)) return false;
-		if (!eraseColumnNumber(coor.second, number)) return false;
-		if (!eraseBlockNumber(block, number)) return false;
-		return true;
+		const bool row = eraseRowNumber(coor.first, number);
+		if (!row && recordMode) return false;
+		const bool column = eraseColumnNumber(coor.second, number);
+		if (!column && recordMode) return false;
+		return eraseBlockNumber(block, number) && row && column;
 	}
 
 	/// <summary>
@@ -248,6 +336,41 @@ namespace YYYCZ {
 		return eraseNumberFromPlace(number, index);
 	}
 
+	/// <summary>
+	/// remove the number of one place, and give the number back to the place and its peers
+	/// if their row, column and block don't have it any more
+	/// </summary>
+	/// <param name="index">index</param>
+	void FastSudoku::removeNumberFromForm(index_t index)
+	{
+		const save_t number = form[index];
+		doOperate({ removeForm, number, index });
+
+		// the numbers of this place
+		for (save_t i = 1; i <= (save_t)formLength; ++i) {
+			if (isNumberFree(i, index)) {
+				save_t size = (save_t)mapper[index].size();
+				doOperate({ restoreMapper, i, index });
+				doOperate({ raiseRank, size, index });
+			}
+		}
+
+		// the number of the peers
+		auto restore = [&](index_t peer) {
+			if (form[peer] != 0 || mapper[peer].count(number) != 0 || !isNumberFree(number, peer)) return;
+			save_t size = (save_t)mapper[peer].size();
+			doOperate({ restoreMapper, number, peer });
+			doOperate({ raiseRank, size, peer });
+		};
+		auto coor = translate(index);
+		auto block = getBlock(coor);
+		for (save_t i = 0; i < (save_t)formLength; ++i) {
+			restore(translate(coor.first, i));
+			restore(translate(i, coor.second));
+			restore(translate(blockAt(block, i)));
+		}
+	}
+
 	/// <summary>
 	/// find a place with minimum choices
 	/// </summary>
@@ -256,12 +379,81 @@ namespace YYYCZ {
 	{
 		for (save_t i = 1; i <= formLength; ++i) {
 			if (!this->rank[i].empty()) {
+				if (tieBreak == TieBreak_LowestIndex) {
+					return *std::min_element(this->rank[i].begin(), this->rank[i].end());
+				}
+				if (tieBreak == TieBreak_HighestIndex) {
+					return *std::max_element(this->rank[i].begin(), this->rank[i].end());
+				}
+				if (tieBreak == TieBreak_Random) {
+					auto itr = this->rank[i].begin();
+					std::advance(itr, random() % this->rank[i].size());
+					return *itr;
+				}
 				return *this->rank[i].begin();
 			}
 		}
 		return formSize;
 	}
 
+	/// <summary>
+	/// find a number which can be filled in only one place of a row, column or block.
+	/// only for the form whose length is less than 64, the candidates are bits
+	/// </summary>
+	/// <param name="number">the number found, or the number can't be filled</param>
+	/// <param name="place">the index of place found</param>
+	/// <param name="unitFound">the unit found: rows, columns, then blocks</param>
+	/// <returns>1 if found, 0 if not found, -1 if a number can't be filled in a unit</returns>
+	int FastSudoku::findHiddenSingle(save_t& number, index_t& place, index_t* unitFound) const
+	{
+		if (formLength >= 64) return 0;
+		const index_t stride = formLength + 1;
+		const mask_t all = ((1ull << formLength) - 1) << 1;
+		for (index_t unit = 0; unit < 3 * formLength; ++unit) {
+			// the numbers can be filled in one place, and in more places
+			mask_t once = 0, twice = 0, placed = 0;
+			for (save_t i = 0; i < (save_t)formLength; ++i) {
+				const index_t index = unitPlace(unit, i);
+				if (form[index] != 0) continue;
+				twice |= once & candidateMask[index];
+				once |= candidateMask[index];
+			}
+			for (save_t i = 1; i <= (save_t)formLength; ++i) {
+				if (unitCounter[unit * stride + i]) placed |= bitOf(i);
+			}
+			if (unitFound) *unitFound = unit;
+			if ((once | placed) != all) {
+				const mask_t missing = all & ~(once | placed);
+				number = 1;
+				while (!((missing >> number) & 1)) ++number;
+				return -1;
+			}
+
+			const mask_t singles = once & ~twice;
+			if (singles) {
+				number = 1;
+				while (!((singles >> number) & 1)) ++number;
+				for (save_t i = 0; i < (save_t)formLength; ++i) {
+					place = unitPlace(unit, i);
+					if (form[place] == 0 && (candidateMask[place] & bitOf(number))) return 1;
+				}
+			}
+		}
+		return 0;
+	}
+
+	/// <summary>
+	/// get the ith place of a unit
+	/// </summary>
+	/// <param name="unit">the unit: rows, columns, then blocks</param>
+	/// <param name="i">the ith of the unit</param>
+	/// <returns>index</returns>
+	inline FastSudoku::index_t FastSudoku::unitPlace(index_t unit, save_t i) const
+	{
+		const save_t kind = unit / formLength, k = unit % formLength;
+		return kind == 0 ? translate(k, i) : kind == 1 ? translate(i, k) : translate(blockAt(k, i));
+	}
+
 	/// <summary>
 	/// go to the dead end, need to flash back
 	/// </summary>
@@ -291,12 +483,45 @@ namespace YYYCZ {
 		}
 	}
 
+	/// <summary>
+	/// fill the places with one choice until no such place
+	/// </summary>
+	/// <returns>false if a place has no choice</returns>
+	bool FastSudoku::fillSingles()
+	{
+		while (finishCount != formSize) {
+			const index_t index = findMinimumChoicesPlace();
+			if (index == formSize) return false;
+			if (mapper[index].size() != 1) return true;
+			if (!putNumberIntoForm(*mapper[index].begin(), index)) return false;
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// get the numbers can be filled of the place, ascending
+	/// </summary>
+	/// <param name="index">index of place</param>
+	/// <param name="choices">the numbers</param>
+	void FastSudoku::choicesOf(index_t index, std::vector<save_t>& choices) const
+	{
+		choices.clear();
+		if (formLength < 64) {
+			for (save_t number = 1; number <= (save_t)formLength; ++number) {
+				if ((candidateMask[index] >> number) & 1) choices.push_back(number);
+			}
+			return;
+		}
+		choices.assign(mapper[index].begin(), mapper[index].end());
+		std::sort(choices.begin(), choices.end());
+	}
+
 	/// <summary>
 	/// init the sudoku form
 	/// </summary>
 	/// <param name="form">sudoku form</param>
-	/// <param name="formDim">the dimension of the form</param>
-	void FastSudoku::init(const save_t* form, const index_t formDim)
+	/// <param name="geometry">the blocks of the form, not init if null</param>
+	void FastSudoku::init(const save_t* form, const std::shared_ptr<const SudokuGeometry>& geometry)
 	{
 		// reset but not clear settings
 		auto tpTMP = tpBegin;
@@ -305,11 +530,16 @@ namespace YYYCZ {
 
 		// don't record the operate when init
 		recordMode = false;
+		contradiction = false;
 
 		// get the base parameters
-		this->formDim = formDim;
-		this->formLength = this->formDim * this->formDim;
-		this->formSize = this->formLength * this->formLength;
+		if (!geometry) return;
+		this->geometry = geometry;
+		this->blockTable = geometry->getBlocks();
+		this->placeTable = geometry->getPlaces();
+		this->formDim = geometry->getDimension();
+		this->formLength = geometry->getLength();
+		this->formSize = geometry->getSize();
 		this->finishCount = 0;
 
 		// init the form
@@ -321,20 +551,29 @@ namespace YYYCZ {
 			mapperInit.insert(i);
 		}
 		this->mapper.resize(formSize, mapperInit);
+		this->candidateMask.assign(formSize, formLength < 64 ? ((1ull << formLength) - 1) << 1 : ~1ull);
+		this->givenBits.assign((formSize + 63) / 64, 0);
 
 		// init the rank
 		this->rank.resize(1 + formLength, std::unordered_set<index_t>());
-		for (index_t i = 1; i <= formSize; ++i) {
+		for (index_t i = 0; i < formSize; ++i) {
 			this->rank.back().insert(i);
 		}
 
-		// do some base operates without recording
+		// init the counter of units
+		this->unitCounter.assign(3 * formLength * (formLength + 1), 0);
+		this->unitHolder.assign(3 * formLength * (formLength + 1), 0);
+
+		// do some base operates without recording, the search isn't needed if the givens conflict
 		index_t index = 0;
 		for (auto& i : this->form) {
 			if (0 < i && formLength >= i) {
 				++finishCount;
 				original.insert(index);
-				eraseNumberFromPlace(i, index);
+				givenBits[index >> 6] |= 1ull << (index & 63);
+				if (!isNumberFree(i, index)) contradiction = true;
+				countNumber(i, index, 1);
+				if (!eraseNumberFromPlace(i, index)) contradiction = true;
 			}
 			else {
 				i = 0;
@@ -349,17 +588,166 @@ namespace YYYCZ {
 	/// <param name="form">sudoku form</param>
 	inline void FastSudoku::init(const std::vector<save_t>& form)
 	{
-		this->init(&form[0], (index_t)sqrt(sqrt(form.size())));
+		this->init(form.data(), geometryOf(form.size(), layout));
+	}
+
+	/// <summary>
+	/// choose the place to try: the place with minimum choices found, the same as before
+	/// </summary>
+	/// <param name="sudoku">the sudoku</param>
+	/// <param name="minIndex">a place with minimum choices</param>
+	/// <returns>the place</returns>
+	inline FastSudoku::index_t FastSudoku::CellMinimumChoices::select(const FastSudoku& /*sudoku*/, index_t minIndex)
+	{
+		return minIndex;
+	}
+
+	/// <summary>
+	/// choose the place to try: in the places with minimum choices, the one with most blank peers,
+	/// it limits the most places
+	/// </summary>
+	/// <param name="sudoku">the sudoku</param>
+	/// <param name="minIndex">a place with minimum choices</param>
+	/// <returns>the place</returns>
+	FastSudoku::index_t FastSudoku::CellDegree::select(const FastSudoku& sudoku, index_t minIndex)
+	{
+		const auto& places = sudoku.rank[sudoku.mapper[minIndex].size()];
+		index_t best = minIndex;
+		index_t bestDegree = 0;
+		for (auto index : places) {
+			// the blank peers in row, column and block, the place itself is not blank
+			auto coor = sudoku.translate(index);
+			auto block = sudoku.getBlock(coor);
+			index_t degree = 0;
+			for (save_t i = 0; i < (save_t)sudoku.formLength; ++i) {
+				degree += sudoku.form[sudoku.translate(coor.first, i)] == 0;
+				degree += sudoku.form[sudoku.translate(i, coor.second)] == 0;
+				degree += sudoku.form[sudoku.translate(sudoku.blockAt(block, i))] == 0;
+			}
+			if (degree > bestDegree || (degree == bestDegree && index < best)) {
+				best = index;
+				bestDegree = degree;
+			}
+		}
+		return best;
+	}
+
+	/// <summary>
+	/// order the numbers to try by the setting of value order, the same as before
+	/// </summary>
+	/// <param name="sudoku">the sudoku</param>
+	/// <param name="index">the place</param>
+	/// <param name="choices">the numbers</param>
+	inline void FastSudoku::ValueSetOrder::order(FastSudoku& sudoku, index_t /*index*/, std::vector<save_t>& choices)
+	{
+		if (sudoku.valueOrder == ValueOrder_Ascending) {
+			std::sort(choices.begin(), choices.end());
+		}
+		else if (sudoku.valueOrder == ValueOrder_Descending) {
+			std::sort(choices.begin(), choices.end(), std::greater<save_t>());
+		}
+		else if (sudoku.valueOrder == ValueOrder_Random) {
+			std::shuffle(choices.begin(), choices.end(), sudoku.random);
+		}
+	}
+
+	/// <summary>
+	/// order the numbers to try: the number removing the fewest choices of peers first
+	/// </summary>
+	/// <param name="sudoku">the sudoku</param>
+	/// <param name="index">the place</param>
+	/// <param name="choices">the numbers</param>
+	void FastSudoku::ValueLeastConstraining::order(FastSudoku& sudoku, index_t index, std::vector<save_t>& choices)
+	{
+		auto coor = sudoku.translate(index);
+		auto block = sudoku.getBlock(coor);
+		std::vector<std::pair<index_t, save_t>> costs;
+		for (auto number : choices) {
+			// the peers may be counted twice, it is the same for all numbers
+			auto has = [&](index_t peer) -> index_t {
+				if (peer == index || sudoku.form[peer] != 0) return 0;
+				if (sudoku.formLength < 64) return (sudoku.candidateMask[peer] >> number) & 1;
+				return (index_t)sudoku.mapper[peer].count(number);
+			};
+			index_t cost = 0;
+			for (save_t i = 0; i < (save_t)sudoku.formLength; ++i) {
+				cost += has(sudoku.translate(coor.first, i));
+				cost += has(sudoku.translate(i, coor.second));
+				cost += has(sudoku.translate(sudoku.blockAt(block, i)));
+			}
+			costs.emplace_back(cost, number);
+		}
+		std::sort(costs.begin(), costs.end());
+		for (size_t i = 0; i < costs.size(); ++i) choices[i] = costs[i].second;
+	}
+
+	/// <summary>
+	/// order the numbers to try: the number filled most on the board first, it has the fewest places left
+	/// </summary>
+	/// <param name="sudoku">the sudoku</param>
+	/// <param name="index">the place</param>
+	/// <param name="choices">the numbers</param>
+	void FastSudoku::ValueFrequency::order(FastSudoku& sudoku, index_t /*index*/, std::vector<save_t>& choices)
+	{
+		// the count of a number in all rows
+		const index_t stride = sudoku.formLength + 1;
+		std::vector<std::pair<index_t, save_t>> counts;
+		for (auto number : choices) {
+			index_t count = 0;
+			for (index_t row = 0; row < sudoku.formLength; ++row) {
+				count += sudoku.unitCounter[row * stride + number];
+			}
+			counts.emplace_back(sudoku.formLength - count, number);
+		}
+		std::sort(counts.begin(), counts.end());
+		for (size_t i = 0; i < counts.size(); ++i) choices[i] = counts[i].second;
 	}
 
 	/// <summary>
-	/// solve the soduku
+	/// solve the soduku by the policies of search
 	/// </summary>
 	/// <returns>if solve successfully</returns>
 	bool FastSudoku::solve()
 	{
-		// iteration times + 1
+		if (learning) {
+			levels_t conflict;
+			return searchLearning(0, conflict);
+		}
+		if (variant && !variant->cages.empty()) return solveWith<ConstraintsKiller>();
+		if (variant) return solveWith<ConstraintsPeers>();
+		return solveWith<ConstraintsClassic>();
+	}
+
+	/// <summary>
+	/// solve the soduku with the constraints, by the policies of search
+	/// </summary>
+	/// <returns>if solve successfully</returns>
+	template<typename Constraints>
+	bool FastSudoku::solveWith()
+	{
+		if (cellPolicy == CellPolicy_Degree) {
+			if (valuePolicy == ValuePolicy_LeastConstraining) return search<CellDegree, ValueLeastConstraining, Constraints>();
+			if (valuePolicy == ValuePolicy_Frequency) return search<CellDegree, ValueFrequency, Constraints>();
+			return search<CellDegree, ValueSetOrder, Constraints>();
+		}
+		if (valuePolicy == ValuePolicy_LeastConstraining) return search<CellMinimumChoices, ValueLeastConstraining, Constraints>();
+		if (valuePolicy == ValuePolicy_Frequency) return search<CellMinimumChoices, ValueFrequency, Constraints>();
+		return search<CellMinimumChoices, ValueSetOrder, Constraints>();
+	}
+
+	/// <summary>
+	/// solve the soduku, the policies choose the place and order the numbers to try,
+	/// and the constraints keep the rules of variant
+	/// </summary>
+	/// <returns>if solve successfully</returns>
+	template<typename CellPolicy, typename ValuePolicy, typename Constraints>
+	bool FastSudoku::search()
+	{
+		// iteration times + 1, and stop if over the limits
 		++iterationTimes;
+		if (limits && isOverLimits()) {
+			return false;
+		}
 
 		// need to record to get back when solving failed
 		recordMode = true;
@@ -381,24 +769,47 @@ namespace YYYCZ {
 
 			// one choice
 			if (mapper[minIndex].size() == 1) {
-				if (!putNumberIntoForm(*mapper[minIndex].begin(), minIndex)) {
+				const save_t number = *mapper[minIndex].begin();
+				if (!putNumberIntoForm(number, minIndex) || !Constraints::afterPut(*this, number, minIndex)) {
 					return false;
 				}
+				continue;
 			}
-			else {
-				break;
+
+			// one place for a number
+			if (propagation == Propagation_HiddenSingles) {
+				save_t number;
+				index_t place;
+				int found = findHiddenSingle(number, place);
+				if (found < 0) return false;
+				if (found > 0) {
+					if (!putNumberIntoForm(number, place) || !Constraints::afterPut(*this, number, place)) {
+						return false;
+					}
+					continue;
+				}
 			}
+
+			// the rules of variant, like the sums of cages
+			const int settled = Constraints::settle(*this);
+			if (settled < 0) return false;
+			if (settled > 0) continue;
+			break;
 		}
 
 		// try fill...
+		minIndex = CellPolicy::select(*this, minIndex);
 		std::vector<save_t> choices(mapper[minIndex].begin(), mapper[minIndex].end());
+		ValuePolicy::order(*this, minIndex, choices);
 		for (auto i : choices) {
 			save();
-			if (putNumberIntoForm(i, minIndex) && solve()) {
+			if (putNumberIntoForm(i, minIndex) && Constraints::afterPut(*this, i, minIndex)
+				&& search<CellPolicy, ValuePolicy, Constraints>()) {
 				return true;
 			}
 			else {
 				flashBack();
+				if (stopStatus) return false;
 			}
 		}
 
@@ -406,171 +817,868 @@ namespace YYYCZ {
 	}
 
 	/// <summary>
-	/// get the original places
+	/// erase one number from one blank place
 	/// </summary>
-	/// <returns>original places</returns>
-	const decltype(FastSudoku::original)& FastSudoku::getOrigin() const
+	/// <param name="number">number</param>
+	/// <param name="index">index of place</param>
+	/// <returns>false if the place has no choice</returns>
+	inline bool FastSudoku::eraseCandidate(save_t number, index_t index)
 	{
-		return original;
+		if (form[index] != 0 || mapper[index].find(number) == mapper[index].end()) return true;
+		SudokuOperate op1{ eraseMapper, number, index }, op2{ moveRank, (save_t)mapper[index].size(), index };
+		doOperate(op1);
+		doOperate(op2);
+		return !mapper[index].empty();
 	}
 
 	/// <summary>
-	/// get the result of solving sudoku
+	/// erase the number from the peers of the variant: the diagonals, a king's or knight's move and the cage
 	/// </summary>
-	/// <returns>solve. if no solve, return empty vector</returns>
-	const decltype(FastSudoku::form)& FastSudoku::getResult() const
+	/// <param name="number">the number put</param>
+	/// <param name="index">index of place</param>
+	/// <returns>false if a peer is the number or has no choice</returns>
+	bool FastSudoku::eraseVariantPeers(save_t number, index_t index)
 	{
-		return form;
+		for (index_t peer : variant->peers[index]) {
+			if (form[peer] == number || !eraseCandidate(number, peer)) return false;
+		}
+		return true;
 	}
 
 	/// <summary>
-	/// get the records
+	/// keep the numbers of the blanks of a cage which can make the sum.
+	/// the combinations of different numbers for the blanks are found from the small numbers,
+	/// cut by the bounds of sum. if there are too many, only the bounds of every number are used
 	/// </summary>
-	/// <returns>records</returns>
-	const decltype(FastSudoku::records)& FastSudoku::getRecords() const
+	/// <param name="cage">which cage</param>
+	/// <returns>-1 if the sum can't be made, 1 if some numbers are erased, 0 if nothing changed</returns>
+	int FastSudoku::propagateCage(index_t cage)
 	{
-		return records;
+		const auto& places = variant->cages[cage].places;
+		int sumLeft = (int)variant->cages[cage].sum;
+		mask_t used = 0, pool = 0;
+		index_t blanks = 0;
+		for (index_t place : places) {
+			if (form[place]) {
+				sumLeft -= form[place];
+				used |= bitOf(form[place]);
+			}
+			else {
+				++blanks;
+				pool |= candidateMask[place];
+			}
+		}
+		if (blanks == 0) return sumLeft == 0 ? 0 : -1;
+		pool &= ~used;
+
+		// the numbers can be used, ascending
+		save_t numbers[64];
+		index_t count = 0;
+		for (save_t number = 1; number <= (save_t)formLength; ++number) {
+			if ((pool >> number) & 1) numbers[count++] = number;
+		}
+		if (count < blanks || sumLeft <= 0) return -1;
+
+		// the combinations, every blank must have a number of it
+		struct Finder {
+			const FastSudoku& sudoku;
+			const std::vector<index_t>& places;
+			const save_t* numbers;
+			index_t count;
+			index_t budget = 4096;
+			mask_t allowed = 0;
+
+			void find(index_t from, index_t left, int sum, mask_t chosen)
+			{
+				if (left == 0) {
+					if (sum != 0) return;
+					for (index_t place : places) {
+						if (!sudoku.form[place] && !(sudoku.candidateMask[place] & chosen)) return;
+					}
+					allowed |= chosen;
+					return;
+				}
+				for (index_t i = from; i + left <= count && budget; ++i) {
+					--budget;
+					// the smallest and the largest sums of the numbers from i
+					int least = 0, most = 0;
+					for (index_t k = 0; k < left; ++k) {
+						least += numbers[i + k];
+						most += numbers[count - 1 - k];
+					}
+					if (least > sum) break;
+					if (most < sum) return;
+					find(i + 1, left - 1, sum - numbers[i], chosen | bitOf(numbers[i]));
+				}
+			}
+		} finder{ *this, places, numbers, count };
+		finder.find(0, blanks, sumLeft, 0);
+
+		mask_t allowed = finder.allowed;
+		if (!finder.budget) {
+			// too many, the number is kept if the others can make the rest of sum
+			allowed = 0;
+			for (index_t i = 0; i < count; ++i) {
+				int least = numbers[i], most = numbers[i];
+				for (index_t k = 0, taken = 0; k < count && taken + 1 < blanks; ++k) {
+					if (k == i) continue;
+					least += numbers[k];
+					++taken;
+				}
+				for (index_t k = count, taken = 0; k-- > 0 && taken + 1 < blanks; ) {
+					if (k == i) continue;
+					most += numbers[k];
+					++taken;
+				}
+				if (least <= sumLeft && sumLeft <= most) allowed |= bitOf(numbers[i]);
+			}
+		}
+		if (!allowed) return -1;
+
+		int changed = 0;
+		for (index_t place : places) {
+			if (form[place]) continue;
+			mask_t erased = candidateMask[place] & ~allowed;
+			for (save_t number = 1; erased; ++number) {
+				if (!((erased >> number) & 1)) continue;
+				erased &= ~bitOf(number);
+				if (!eraseCandidate(number, place)) return -1;
+				changed = 1;
+			}
+		}
+		return changed;
 	}
 
 	/// <summary>
-	/// get the times of iteration
+	/// apply the rules of variant to the givens, after init
 	/// </summary>
-	/// <returns>iteration times</returns>
-	FastSudoku::index_t FastSudoku::getIterationTimes() const
+	/// <returns>false if the givens break the rules</returns>
+	bool FastSudoku::initVariant()
 	{
-		return iterationTimes;
+		for (index_t index = 0; index < formSize; ++index) {
+			if (form[index] && !eraseVariantPeers(form[index], index)) return false;
+		}
+		return ConstraintsKiller::settle(*this) >= 0;
 	}
 
 	/// <summary>
-	/// reset the fastSudoku
+	/// the number is put, erase it from the peers of variant
 	/// </summary>
-	/// <param name="clearSettings">if to clear all settings</param>
-	/// <returns>FastSudoku</returns>
-	FastSudoku& FastSudoku::reset(bool clearSettings)
+	/// <param name="sudoku">the sudoku</param>
+	/// <param name="number">the number put</param>
+	/// <param name="index">index of place</param>
+	/// <returns>if ok</returns>
+	inline bool FastSudoku::ConstraintsPeers::afterPut(FastSudoku& sudoku, save_t number, index_t index)
 	{
-		this->formDim = 0;
-		this->formSize = 0;
-		this->formLength = 0;
-		this->finishCount = 0;
-		this->iterationTimes = 0;
-		this->form.clear();
-		this->mapper.clear();
-		this->rank.clear();
-		this->original.clear();
-		this->records.clear();
-		this->changePlace.clear();
-		this->tpBegin = decltype(this->tpBegin)();
-		this->tpEnd = decltype(this->tpEnd)();
-		if (clearSettings) {
-			this->recordMode = false;
-			this->markChange = false;
-			this->showAfterFill = false;
-			this->timingMode = 0;
-		}
-		return *this;
+		return sudoku.eraseVariantPeers(number, index);
 	}
 
 	/// <summary>
-	/// print the form
+	/// the number is put, erase it from the peers of variant and check the cages of the place
 	/// </summary>
-	/// <param name="selected">the item be selected</param>
-	/// <returns>FastSudoku</returns>
-	FastSudoku& FastSudoku::printForm(const index_t* selected)
+	/// <param name="sudoku">the sudoku</param>
+	/// <param name="number">the number put</param>
+	/// <param name="index">index of place</param>
+	/// <returns>if ok</returns>
+	inline bool FastSudoku::ConstraintsKiller::afterPut(FastSudoku& sudoku, save_t number, index_t index)
 	{
-		if (!__CheckIfInit()) {
-			std::cout << "No solve." << std::endl;
-			return *this;
+		if (!sudoku.eraseVariantPeers(number, index)) return false;
+		for (index_t cage : sudoku.variant->cagesOf[index]) {
+			if (sudoku.propagateCage(cage) < 0) return false;
 		}
+		return true;
+	}
 
-		for (save_t i = 0; i < formLength; ++i) {
-			for (save_t j = 0; j < formLength; ++j) {
-				index_t index = translate(i, j);
-				if (selected && index == *selected) {
-					std::cout << "\033[44m";
-				}
-				std::cout << ' ';
-				if (changePlace.find(index) != changePlace.end()) {
-					if (form[index] == 0) {
-						std::cout << "\033[31m" << 'X';
-					}
-					else {
-						std::cout << "\033[31m" << form[index];
-					}
-				}
-				else if (original.find(index) != original.end()) {
-					std::cout << "\033[32m" << form[index];
-				}
-				else if (form[index] != 0) {
-					std::cout << "\033[33m" << form[index];
-				}
-				else {
-					std::cout << ' ';
-				}
-				std::cout << " \033[0m";
-				if (j + 1 != formLength) {
-					if ((j + 1) % formDim == 0) {
-						std::cout << "\033[34m|\033[0m";
-					}
-					else {
-						std::cout << "|";
-					}
-				}
-			}
-			std::cout << std::endl;
-			if (i + 1 != formLength) {
-				if ((i + 1) % formDim == 0) {
-					std::cout << "\033[34m";
-					for (save_t j = 0; j < formLength; ++j) {
-						std::cout << "---";
-						if (j + 1 != formLength) {
-							std::cout << '+';
-						}
-					}
-					std::cout << "\033[0m";
-				}
-				else {
-					for (save_t j = 0; j < formLength; ++j) {
-						std::cout << "---";
-						if (j + 1 != formLength) {
-							if ((j + 1) % formDim == 0) {
-								std::cout << "\033[34m+\033[0m";
-							}
-							else {
-								std::cout << '+';
-							}
-						}
-					}
+	/// <summary>
+	/// check the sums of all cages until nothing changed
+	/// </summary>
+	/// <param name="sudoku">the sudoku</param>
+	/// <returns>-1 if a sum can't be made, 1 if some numbers are erased, 0 if nothing changed</returns>
+	int FastSudoku::ConstraintsKiller::settle(FastSudoku& sudoku)
+	{
+		int result = 0;
+		for (bool changed = true; changed; ) {
+			changed = false;
+			for (index_t cage = 0; cage < (index_t)sudoku.variant->cages.size(); ++cage) {
+				const int state = sudoku.propagateCage(cage);
+				if (state < 0) return -1;
+				if (state > 0) {
+					changed = true;
+					result = 1;
 				}
-				std::cout << std::endl;
 			}
 		}
-		changePlace.clear();
-		return *this;
+		return result;
 	}
 
 	/// <summary>
-	/// print the form
+	/// merge the levels, both are sorted
 	/// </summary>
-	/// <param name="row">the row of selected item</param>
-	/// <param name="column">the column of selected item</param>
-	/// <returns>FastSudoku</returns>
-	FastSudoku& FastSudoku::printForm(const save_t row, const save_t column)
+	/// <param name="into">the levels merged into</param>
+	/// <param name="from">the levels</param>
+	void FastSudoku::mergeLevels(levels_t& into, const levels_t& from)
 	{
-		const index_t index = translate(row, column);
-		return printForm(&index);
+		if (from.empty()) return;
+		levels_t merged;
+		merged.reserve(into.size() + from.size());
+		std::set_union(into.begin(), into.end(), from.begin(), from.end(), std::back_inserter(merged));
+		into.swap(merged);
 	}
 
 	/// <summary>
-	/// replay by records
+	/// the key of literal "the place is the number"
 	/// </summary>
-	/// <returns>FastSudoku</returns>
-	/// <param name="stepPlay">if play step by step</param>
-	FastSudoku& FastSudoku::replay(bool stepPlay)
+	/// <param name="place">index of place</param>
+	/// <param name="number">number</param>
+	/// <returns>key</returns>
+	inline FastSudoku::index_t FastSudoku::literalKey(index_t place, save_t number) const
 	{
-		if (!__CheckIfInit()) {
-			std::cout << "No solve." << std::endl;
-			return *this;
-		}
+		return place * (formLength + 1) + number;
+	}
+
+	/// <summary>
+	/// judge if the number can be filled in the place
+	/// </summary>
+	/// <param name="place">index of place</param>
+	/// <param name="number">number</param>
+	/// <returns>if can be filled</returns>
+	inline bool FastSudoku::hasCandidate(index_t place, save_t number) const
+	{
+		if (formLength < 64) return (candidateMask[place] >> number) & 1;
+		return mapper[place].count(number) != 0;
+	}
+
+	/// <summary>
+	/// explain why the number is erased from the place:
+	/// a peer is the number, or a nogood erased it
+	/// </summary>
+	/// <param name="place">index of place</param>
+	/// <param name="number">number</param>
+	/// <param name="level">now level</param>
+	/// <param name="conflict">the levels causing it are merged into</param>
+	void FastSudoku::explainErased(index_t place, save_t number, index_t level, levels_t& conflict) const
+	{
+		// the peer with the lowest levels is the best reason
+		const levels_t* best = nullptr;
+		if (number > 0) {
+			const index_t stride = formLength + 1;
+			const index_t row = place / formLength, column = place % formLength;
+			const index_t units[3] = { row, formLength + column, 2 * formLength + getBlock(row, column) };
+			for (auto unit : units) {
+				if (unitCounter[unit * stride + number] == 0) continue;
+				const index_t peer = unitHolder[unit * stride + number];
+				if (peer == place || form[peer] != number) continue;
+				const levels_t& deps = placeDeps[peer];
+				if (!best || deps.empty() || (!best->empty() && deps.back() < best->back())) best = &deps;
+			}
+		}
+		if (best) {
+			mergeLevels(conflict, *best);
+			return;
+		}
+
+		// erased by a nogood, the latest reason is for now
+		if (form[place] == 0 && number > 0 && !learnedReason[literalKey(place, number)].empty()) {
+			mergeLevels(conflict, learnedReason[literalKey(place, number)]);
+			return;
+		}
+
+		// unknown, all levels are the reason
+		levels_t all;
+		for (index_t i = 1; i <= level; ++i) all.push_back(i);
+		mergeLevels(conflict, all);
+	}
+
+	/// <summary>
+	/// explain why the place has no number to fill
+	/// </summary>
+	/// <param name="place">index of place</param>
+	/// <param name="level">now level</param>
+	/// <param name="conflict">the levels causing it are merged into</param>
+	void FastSudoku::explainEmptyPlace(index_t place, index_t level, levels_t& conflict) const
+	{
+		for (save_t i = 1; i <= (save_t)formLength; ++i) {
+			if (!hasCandidate(place, i)) explainErased(place, i, level, conflict);
+		}
+	}
+
+	/// <summary>
+	/// explain why the number can't be filled in the places of the unit except one
+	/// </summary>
+	/// <param name="unit">the unit</param>
+	/// <param name="number">number</param>
+	/// <param name="except">the place not explained, formSize for none</param>
+	/// <param name="level">now level</param>
+	/// <param name="conflict">the levels causing it are merged into</param>
+	void FastSudoku::explainUnit(index_t unit, save_t number, index_t except, index_t level, levels_t& conflict) const
+	{
+		for (save_t i = 0; i < (save_t)formLength; ++i) {
+			const index_t place = unitPlace(unit, i);
+			if (place == except) continue;
+			if (form[place] != 0) mergeLevels(conflict, placeDeps[place]);
+			else explainErased(place, number, level, conflict);
+		}
+	}
+
+	/// <summary>
+	/// put the number into the place with the levels causing it, and propagate the nogoods
+	/// </summary>
+	/// <param name="number">number</param>
+	/// <param name="place">index of place</param>
+	/// <param name="deps">the levels causing it</param>
+	/// <param name="level">now level</param>
+	/// <param name="conflict">the levels causing the conflict if failed</param>
+	/// <returns>if ok</returns>
+	bool FastSudoku::assignLearning(save_t number, index_t place, levels_t deps, index_t level, levels_t& conflict)
+	{
+		placeDeps[place] = std::move(deps);
+		if (!putNumberIntoForm(number, place)) {
+			// a peer has no number to fill
+			auto coor = translate(place);
+			auto block = getBlock(coor);
+			for (save_t i = 0; i < (save_t)formLength; ++i) {
+				for (index_t peer : { translate(coor.first, i), translate(i, coor.second), translate(blockAt(block, i)) }) {
+					if (form[peer] == 0 && mapper[peer].empty()) {
+						explainEmptyPlace(peer, level, conflict);
+						return false;
+					}
+				}
+			}
+			explainErased(place, 0, level, conflict); // unknown
+			return false;
+		}
+		return propagateNogoods(place, number, level, conflict);
+	}
+
+	/// <summary>
+	/// the literal "place is number" is true now, check the nogoods watching it.
+	/// if all literals of a nogood are true except one, the number of that one is erased
+	/// </summary>
+	/// <param name="place">index of place</param>
+	/// <param name="number">number</param>
+	/// <param name="level">now level</param>
+	/// <param name="conflict">the levels causing the conflict if failed</param>
+	/// <returns>if ok</returns>
+	bool FastSudoku::propagateNogoods(index_t place, save_t number, index_t level, levels_t& conflict)
+	{
+		// 1 true, -1 false, 0 unknown
+		auto state = [&](const literal_t& literal) {
+			if (form[literal.first] != 0) return form[literal.first] == literal.second ? 1 : -1;
+			return hasCandidate(literal.first, literal.second) ? 0 : -1;
+		};
+
+		auto& list = watches[literalKey(place, number)];
+		for (size_t i = 0; i < list.size();) {
+			Nogood& nogood = nogoods[list[i].first];
+			if (nogood.stamp != list[i].second) {
+				// forgotten
+				list[i] = list.back();
+				list.pop_back();
+				continue;
+			}
+
+			// the other watched is false, the nogood can't be broken
+			const index_t w = nogood.literals[nogood.watch[0]] == literal_t(place, number) ? 0 : 1;
+			const literal_t other = nogood.literals[nogood.watch[1 - w]];
+			const int otherState = state(other);
+			if (otherState < 0) {
+				++i;
+				continue;
+			}
+
+			// watch another literal not true
+			bool moved = false;
+			for (index_t j = 0; j < nogood.literals.size(); ++j) {
+				if (j == nogood.watch[0] || j == nogood.watch[1] || state(nogood.literals[j]) == 1) continue;
+				nogood.watch[w] = j;
+				watches[literalKey(nogood.literals[j].first, nogood.literals[j].second)].push_back(list[i]);
+				list[i] = list.back();
+				list.pop_back();
+				moved = true;
+				break;
+			}
+			if (moved) continue;
+
+			// the other watched is the last one not true
+			levels_t reason;
+			for (auto& literal : nogood.literals) {
+				if (literal != other) mergeLevels(reason, placeDeps[literal.first]);
+			}
+			if (otherState == 1) {
+				mergeLevels(reason, placeDeps[other.first]);
+				mergeLevels(conflict, reason);
+				return false;
+			}
+			doOperate({ eraseMapper, other.second, other.first });
+			doOperate({ moveRank, (save_t)mapper[other.first].size() + 1, other.first });
+			learnedReason[literalKey(other.first, other.second)] = std::move(reason);
+			if (mapper[other.first].empty()) {
+				explainEmptyPlace(other.first, level, conflict);
+				return false;
+			}
+			++i;
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// learn the decisions of the levels as a nogood, they can't be made together.
+	/// the oldest nogood is forgotten when full
+	/// </summary>
+	/// <param name="conflict">the levels</param>
+	void FastSudoku::learnNogood(const levels_t& conflict)
+	{
+		if (conflict.size() < 2 || conflict.size() > maxNogoodSize || maxNogoods == 0) return;
+		if (nogoods.size() < maxNogoods) nogoods.emplace_back();
+		const index_t id = nogoodCursor;
+		nogoodCursor = (nogoodCursor + 1) % maxNogoods;
+
+		// watch the two latest decisions, they are undone first
+		Nogood& nogood = nogoods[id];
+		++nogood.stamp;
+		nogood.literals.clear();
+		for (auto level : conflict) nogood.literals.push_back(decisions[level]);
+		nogood.watch[0] = (index_t)conflict.size() - 1;
+		nogood.watch[1] = (index_t)conflict.size() - 2;
+		for (auto w : nogood.watch) {
+			auto& literal = nogood.literals[w];
+			watches[literalKey(literal.first, literal.second)].emplace_back(id, nogood.stamp);
+		}
+		++learnedCount;
+	}
+
+	/// <summary>
+	/// solve the sudoku, explain the conflicts by the decision levels, jump back to the latest level
+	/// causing it, and learn the decisions causing it as nogoods
+	/// </summary>
+	/// <param name="level">now level, the count of decisions</param>
+	/// <param name="conflict">the levels causing the failure</param>
+	/// <returns>if solve successfully</returns>
+	bool FastSudoku::searchLearning(index_t level, levels_t& conflict)
+	{
+		// iteration times + 1, and stop if over the limits
+		++iterationTimes;
+		if (limits && isOverLimits()) {
+			return false;
+		}
+
+		// need to record to get back when solving failed
+		recordMode = true;
+
+		index_t minIndex = formSize;
+		while (true) {
+			// finish!
+			if (finishCount == formSize) {
+				return true;
+			}
+
+			// get the place with minimum choices
+			minIndex = findMinimumChoicesPlace();
+
+			// a place has no number to fill
+			if (minIndex == formSize) {
+				for (index_t i = 0; i < formSize; ++i) {
+					if (form[i] == 0) {
+						explainEmptyPlace(i, level, conflict);
+						break;
+					}
+				}
+				return false;
+			}
+
+			// one choice, caused by the others erased
+			if (mapper[minIndex].size() == 1) {
+				const save_t number = *mapper[minIndex].begin();
+				levels_t deps;
+				for (save_t i = 1; i <= (save_t)formLength; ++i) {
+					if (i != number) explainErased(minIndex, i, level, deps);
+				}
+				if (!assignLearning(number, minIndex, std::move(deps), level, conflict)) {
+					return false;
+				}
+				continue;
+			}
+
+			// one place for a number, caused by the other places
+			if (propagation == Propagation_HiddenSingles) {
+				save_t number;
+				index_t place, unit;
+				int found = findHiddenSingle(number, place, &unit);
+				if (found < 0) {
+					explainUnit(unit, number, formSize, level, conflict);
+					return false;
+				}
+				if (found > 0) {
+					levels_t deps;
+					explainUnit(unit, number, place, level, deps);
+					if (!assignLearning(number, place, std::move(deps), level, conflict)) {
+						return false;
+					}
+					continue;
+				}
+			}
+			break;
+		}
+
+		// the numbers can't be filled are a part of the reason
+		levels_t failure;
+		for (save_t i = 1; i <= (save_t)formLength; ++i) {
+			if (!hasCandidate(minIndex, i)) explainErased(minIndex, i, level, failure);
+		}
+
+		// try fill...
+		std::vector<save_t> choices(mapper[minIndex].begin(), mapper[minIndex].end());
+		ValueSetOrder::order(*this, minIndex, choices);
+		if (decisions.size() < level + 2) decisions.resize(level + 2);
+		for (auto i : choices) {
+			save();
+			decisions[level + 1] = { minIndex, i };
+			levels_t child;
+			if (assignLearning(i, minIndex, { level + 1 }, level + 1, child) && searchLearning(level + 1, child)) {
+				return true;
+			}
+			flashBack();
+			if (stopStatus) return false;
+
+			// this decision is not the cause, jump over the level
+			if (!std::binary_search(child.begin(), child.end(), level + 1)) {
+				conflict.swap(child);
+				++backjumpCount;
+				return false;
+			}
+			learnNogood(child);
+			child.pop_back();
+			mergeLevels(failure, child);
+		}
+
+		conflict.swap(failure);
+		return false;
+	}
+
+	/// <summary>
+	/// check the limits of solving, the clock and the token are checked every poll interval
+	/// </summary>
+	/// <returns>if stop solving</returns>
+	bool FastSudoku::isOverLimits()
+	{
+		if (stopStatus) return true;
+		if (restartAt && iterationTimes >= restartAt) {
+			stopStatus = stopRestart;
+		}
+		else if (limits->maxNodes && iterationTimes > limits->maxNodes) {
+			stopStatus = SolveResult::Status_BudgetExhausted;
+		}
+		else if (limits->pollInterval <= 1 || iterationTimes % limits->pollInterval == 0) {
+			if (limits->cancelToken && limits->cancelToken->load(std::memory_order_relaxed)) {
+				stopStatus = SolveResult::Status_Cancelled;
+			}
+			else if (deadline != clock_t::time_point::max() && clock_t::now() >= deadline) {
+				stopStatus = SolveResult::Status_BudgetExhausted;
+			}
+		}
+		return stopStatus != 0;
+	}
+
+	/// <summary>
+	/// search with restarts, every run is given up after its nodes and the search begins again.
+	/// the random choices make the runs different
+	/// </summary>
+	/// <param name="restarts">the times of restart</param>
+	/// <returns>if solve successfully</returns>
+	bool FastSudoku::searchWithRestarts(index_t& restarts)
+	{
+		restarts = 0;
+		if (!limits || limits->restart == Restart_None) {
+			return solve();
+		}
+
+		// the point to go back
+		recordMode = true;
+		save();
+
+		const double most = (double)std::numeric_limits<index_t>::max();
+		const double base = limits->restartBase ? limits->restartBase : 1;
+		double runNodes = base;
+		while (true) {
+			// the nodes of this run, clamped so the counter of iterations doesn't wrap
+			const double planned = limits->restart == Restart_Luby ? base * luby(restarts + 1) : runNodes;
+			const index_t nodes = (index_t)std::max(1.0, std::min(planned, most - iterationTimes));
+			runNodes = std::min(runNodes * (limits->restartFactor > 1 ? limits->restartFactor : 1), most);
+			restartAt = iterationTimes + nodes;
+
+			if (solve()) {
+				restartAt = 0;
+				return true;
+			}
+			flashBack();
+			if (stopStatus != stopRestart) {
+				restartAt = 0;
+				return false;
+			}
+			stopStatus = 0;
+			++restarts;
+			save();
+		}
+	}
+
+	/// <summary>
+	/// the Luby sequence: 1, 1, 2, 1, 1, 2, 4, 1, 1, 2, 1, 1, 2, 4, 8, ...
+	/// </summary>
+	/// <param name="i">the position, from 1</param>
+	/// <returns>the item</returns>
+	FastSudoku::index_t FastSudoku::luby(index_t i)
+	{
+		while (true) {
+			index_t k = 1;
+			while (((index_t)1 << k) - 1 < i) ++k;
+			if (i == ((index_t)1 << k) - 1) return (index_t)1 << (k - 1);
+			i -= ((index_t)1 << (k - 1)) - 1;
+		}
+	}
+
+	/// <summary>
+	/// get the original places
+	/// </summary>
+	/// <returns>original places</returns>
+	const decltype(FastSudoku::original)& FastSudoku::getOrigin() const
+	{
+		return original;
+	}
+
+	/// <summary>
+	/// get the result of solving sudoku
+	/// </summary>
+	/// <returns>solve. if no solve, return empty vector</returns>
+	const decltype(FastSudoku::form)& FastSudoku::getResult() const
+	{
+		return form;
+	}
+
+	/// <summary>
+	/// get the records
+	/// </summary>
+	/// <returns>records</returns>
+	const decltype(FastSudoku::records)& FastSudoku::getRecords() const
+	{
+		return records;
+	}
+
+	/// <summary>
+	/// get the times of iteration
+	/// </summary>
+	/// <returns>iteration times</returns>
+	FastSudoku::index_t FastSudoku::getIterationTimes() const
+	{
+		return iterationTimes;
+	}
+
+	/// <summary>
+	/// reset the fastSudoku
+	/// </summary>
+	/// <param name="clearSettings">if to clear all settings</param>
+	/// <returns>FastSudoku</returns>
+	FastSudoku& FastSudoku::reset(bool clearSettings)
+	{
+		this->formDim = 0;
+		this->formSize = 0;
+		this->formLength = 0;
+		this->finishCount = 0;
+		this->iterationTimes = 0;
+		this->form.clear();
+		this->mapper.clear();
+		this->rank.clear();
+		this->original.clear();
+		this->unitCounter.clear();
+		this->unitHolder.clear();
+		this->candidateMask.clear();
+		this->givenBits.clear();
+		this->history.clear();
+		this->records.clear();
+		this->changePlace.clear();
+		this->placeDeps.clear();
+		this->learnedReason.clear();
+		this->watches.clear();
+		this->decisions.clear();
+		this->nogoods.clear();
+		this->geometry.reset();
+		this->blockTable = this->placeTable = nullptr;
+		this->variant = nullptr;
+		this->tpBegin = decltype(this->tpBegin)();
+		this->tpEnd = decltype(this->tpEnd)();
+		if (clearSettings) {
+			this->recordMode = false;
+			this->markChange = false;
+			this->showAfterFill = false;
+			this->timingMode = 0;
+			this->solutionCache = nullptr;
+			this->layout.reset();
+		}
+		return *this;
+	}
+
+	/// <summary>
+	/// print the form
+	/// </summary>
+	/// <param name="selected">the item be selected</param>
+	/// <returns>FastSudoku</returns>
+	FastSudoku& FastSudoku::printForm(const index_t* selected)
+	{
+		return printForm(std::cout, selected);
+	}
+
+	/// <summary>
+	/// print the form into the stream
+	/// </summary>
+	/// <param name="out">the stream</param>
+	/// <param name="selected">the item be selected</param>
+	/// <returns>FastSudoku</returns>
+	FastSudoku& FastSudoku::printForm(std::ostream& out, const index_t* selected)
+	{
+		if (!__CheckIfInit()) {
+			out << "No solve.\n";
+			return *this;
+		}
+
+		printGrid(out, *geometry, [&](index_t index) {
+			if (selected && index == *selected) {
+				out << "\033[44m";
+			}
+			out << ' ';
+			if (changePlace.find(index) != changePlace.end()) {
+				if (form[index] == 0) {
+					out << "\033[31m" << 'X';
+				}
+				else {
+					out << "\033[31m" << form[index];
+				}
+			}
+			else if (isOriginal(index)) {
+				out << "\033[32m" << form[index];
+			}
+			else if (form[index] != 0) {
+				out << "\033[33m" << form[index];
+			}
+			else {
+				out << ' ';
+			}
+			out << " \033[0m";
+		});
+		out.flush();
+		changePlace.clear();
+		return *this;
+	}
+
+	/// <summary>
+	/// print a form without solver, such as the solution of SolveResult
+	/// </summary>
+	/// <param name="out">the stream</param>
+	/// <param name="form">the form</param>
+	/// <param name="origin">the view of origin form, its numbers are green</param>
+	void FastSudoku::printForm(std::ostream& out, const std::vector<save_t>& form, const BoardView* origin)
+	{
+		auto geometry = SudokuGeometry::standard(form.size());
+		const SudokuGeometry* blocks = origin && origin->geometry && origin->size == form.size() ? origin->geometry : geometry.get();
+		if (form.empty() || !blocks) {
+			out << "No solve.\n";
+			return;
+		}
+
+		printGrid(out, *blocks, [&](index_t index) {
+			out << ' ';
+			if (origin && origin->size == form.size() && origin->isGiven(index)) {
+				out << "\033[32m" << form[index];
+			}
+			else if (form[index] != 0) {
+				out << "\033[33m" << form[index];
+			}
+			else {
+				out << ' ';
+			}
+			out << " \033[0m";
+		});
+		out.flush();
+	}
+
+	/// <summary>
+	/// print the grid of form, the cells are printed by the function.
+	/// the lines between two blocks are blue
+	/// </summary>
+	/// <param name="out">the stream</param>
+	/// <param name="geometry">the blocks of form</param>
+	/// <param name="printCell">print the cell of index</param>
+	void FastSudoku::printGrid(std::ostream& out, const SudokuGeometry& geometry, const std::function<void(index_t)>& printCell)
+	{
+		const index_t length = geometry.getLength();
+		auto apart = [&](index_t a, index_t b) { return geometry.blockOf(a) != geometry.blockOf(b); };
+		for (index_t i = 0; i < length; ++i) {
+			for (index_t j = 0; j < length; ++j) {
+				printCell(i * length + j);
+				if (j + 1 != length) {
+					if (apart(i * length + j, i * length + j + 1)) {
+						out << "\033[34m|\033[0m";
+					}
+					else {
+						out << "|";
+					}
+				}
+			}
+			out << '\n';
+			if (i + 1 != length) {
+				// the color is changed only when the next piece is not the same color
+				bool blue = false;
+				auto piece = [&](const char* text, bool isBlue) {
+					if (isBlue != blue) out << (isBlue ? "\033[34m" : "\033[0m");
+					blue = isBlue;
+					out << text;
+				};
+				for (index_t j = 0; j < length; ++j) {
+					const index_t up = i * length + j, down = up + length;
+					piece("---", apart(up, down));
+					if (j + 1 != length) {
+						piece("+", apart(up, down) || apart(up, up + 1) || apart(down, down + 1) || apart(up + 1, down + 1));
+					}
+				}
+				if (blue) out << "\033[0m";
+				out << '\n';
+			}
+		}
+	}
+
+	/// <summary>
+	/// print the form
+	/// </summary>
+	/// <param name="row">the row of selected item</param>
+	/// <param name="column">the column of selected item</param>
+	/// <returns>FastSudoku</returns>
+	FastSudoku& FastSudoku::printForm(const save_t row, const save_t column)
+	{
+		return printForm(std::cout, row, column);
+	}
+
+	/// <summary>
+	/// print the form into the stream
+	/// </summary>
+	/// <param name="out">the stream</param>
+	/// <param name="row">the row of selected item</param>
+	/// <param name="column">the column of selected item</param>
+	/// <returns>FastSudoku</returns>
+	FastSudoku& FastSudoku::printForm(std::ostream& out, const save_t row, const save_t column)
+	{
+		const index_t index = translate(row, column);
+		return printForm(out, &index);
+	}
+
+	/// <summary>
+	/// replay by records
+	/// </summary>
+	/// <returns>FastSudoku</returns>
+	/// <param name="stepPlay">if play step by step</param>
+	FastSudoku& FastSudoku::replay(bool stepPlay)
+	{
+		if (!__CheckIfInit()) {
+			std::cout << "No solve." << std::endl;
+			return *this;
+		}
 
 		// to wait user press
 		auto waitPress = [&]() {
@@ -580,80 +1688,443 @@ namespace YYYCZ {
 				std::cout << "\r                             " << std::endl;
 			}
 			else {
-				std::cout << std::endl;
+				std::cout << std::endl;
+			}
+		};
+
+		// recover the form
+		auto recordsCopy = records;
+		while (flashBack());
+
+		// show original
+		std::cout << "Original form:" << std::endl;
+		printForm();
+		waitPress();
+
+		// start replay
+		for (auto& i : recordsCopy) {
+			if (i.type == inputForm) {
+				auto coor = translate(i.p2);
+				std::cout << "Fill " << i.p1 << " into ("
+					<< (coor.first + 1) << ',' << (coor.second + 1) << ')' << std::endl;
+				putNumberIntoForm(i.p1, i.p2);
+				changePlace.insert(i.p2);
+				printForm();
+				waitPress();
+			}
+		}
+		records.swap(recordsCopy);
+
+		// show finish
+		std::cout << "Final form:" << std::endl;
+		printForm();
+		waitPress();
+
+		return *this;
+	}
+
+	/// <summary>
+	/// set the change mark
+	/// </summary>
+	/// <param name="flag">new flag</param>
+	/// <returns>FastSudoku</returns>
+	FastSudoku& FastSudoku::setMarkChange(bool flag)
+	{
+		markChange = flag;
+		return *this;
+	}
+
+	/// <summary>
+	/// init, solve and get the result.
+	/// if no solve, return empty vector
+	/// </summary>
+	/// <param name="form">the sudoku form</param>
+	/// <returns>FastSudoku</returns>
+	FastSudoku& FastSudoku::solve(const std::vector<save_t>& form)
+	{
+		if (timingMode == 1 || timingMode == 3) {
+			tpBegin = clock_t::now();
+		}
+		bool learn = false;
+		const char backend = selectBackend(form, geometryOf(form.size(), layout), backendSelector.get(), learn);
+		if (timingMode == 1) {
+			tpEnd = clock_t::now();
+		}
+		else if (timingMode == 2) {
+			tpBegin = clock_t::now();
+		}
+
+		if (backend == Backend_Search && !learn) {
+			solveWithCache(true);
+		}
+		else if (geometry) {
+			// solved by the other backend, then the solution is filled into the givens
+			SolveOptions options;
+			options.backend = backend;
+			options.learning = learn;
+			options.geometry = geometry;
+			const std::vector<save_t> givens = this->form;
+			auto result = solve(givens, options);
+			init(givens.data(), options.geometry);
+			for (index_t i = 0; i < formSize && result.isSolved(); ++i) {
+				if (this->form[i] == 0) putNumberIntoForm(result.solution[i], i);
+			}
+		}
+
+		if (timingMode == 2 || timingMode == 3) {
+			tpEnd = clock_t::now();
+		}
+		return *this;
+	}
+
+	/// <summary>
+	/// solve the form inited, find in the cache first.
+	/// if no solve, the form is cleared
+	/// </summary>
+	/// <param name="useCache">if use the cache</param>
+	/// <param name="fromCache">set if the solution is from the cache</param>
+	/// <param name="restarts">set the times of restart</param>
+	/// <returns>if solve successfully</returns>
+	bool FastSudoku::solveWithCache(bool useCache, bool* fromCache, index_t* restarts)
+	{
+		if (!__CheckIfInit()) return false;
+		if (contradiction) {
+			this->form.clear();
+			return false;
+		}
+
+		// the keys of cache are the forms only, so the other layouts don't use it
+		SolutionCache* cache = useCache && geometry->isStandard() && !variant ? solutionCache : nullptr;
+		SolutionCache::Key key;
+		std::vector<save_t> cached;
+		if (cache) key = cache->makeKey(this->form);
+		if (cache && cache->find(key, cached)) {
+			this->form.swap(cached);
+			if (!this->form.empty()) finishCount = formSize;
+			if (fromCache) *fromCache = true;
+		}
+		else {
+			index_t restartTimes = 0;
+			if (!searchWithRestarts(restartTimes)) this->form.clear();
+			if (restarts) *restarts = restartTimes;
+			if (cache && !stopStatus) cache->store(key, this->form);
+		}
+		return !this->form.empty();
+	}
+
+	/// <summary>
+	/// solve the form by the SAT backend. the board of search is not built,
+	/// the form is encoded as CNF, so the large sudokus are fast
+	/// </summary>
+	/// <param name="form">the sudoku form</param>
+	/// <param name="useCache">if use the cache of solutions set</param>
+	/// <param name="result">the solution and the statistics</param>
+	/// <returns>if solve successfully</returns>
+	bool FastSudoku::solveBySat(const std::vector<save_t>& form, const SudokuGeometry& geometry, bool useCache, SolveResult& result)
+	{
+		SolutionCache* cache = useCache && geometry.isStandard() ? solutionCache : nullptr;
+		SolutionCache::Key key;
+		if (cache) key = cache->makeKey(form);
+		if (cache && cache->find(key, result.solution)) {
+			result.fromCache = true;
+			return !result.solution.empty();
+		}
+
+		SudokuCnf cnf;
+		cnf.encode(form, &geometry);
+		SatSolver sat;
+		sat.load(cnf.getVariableCount(), cnf.getClauses());
+		iterationTimes = 0;
+		const char status = sat.solve([this](index_t decisions) {
+			iterationTimes = decisions;
+			return limits && isOverLimits();
+		});
+		iterationTimes = sat.getDecisions();
+		result.restarts = sat.getRestarts();
+		result.nogoods = sat.getLearnedCount();
+		result.backjumps = sat.getBackjumps();
+
+		if (status == SatSolver::Status_Satisfiable) cnf.decode(sat.getModel(), result.solution);
+		if (cache && !stopStatus) cache->store(key, result.solution);
+		return !result.solution.empty();
+	}
+
+	/// <summary>
+	/// init the form and choose the backend by the features of it.
+	/// the nodes are estimated before init if the selector needs them
+	/// </summary>
+	/// <param name="form">the sudoku form</param>
+	/// <param name="blocks">the blocks of the form, only init if null</param>
+	/// <param name="selector">the model, null for the rules of size</param>
+	/// <param name="learn">set true if the search learning the nogoods is chosen, not changed else</param>
+	/// <returns>the backend, Backend_X</returns>
+	char FastSudoku::selectBackend(const std::vector<save_t>& form, const std::shared_ptr<const SudokuGeometry>& blocks,
+		const SudokuSelector* selector, bool& learn)
+	{
+		if (&this->form == &form) {
+			auto formCopy = form;
+			return selectBackend(formCopy, blocks, selector, learn);
+		}
+
+		double nodes = 0;
+		if (selector && selector->getProbes() && blocks) {
+			EstimateOptions probing;
+			probing.probes = selector->getProbes();
+			probing.geometry = blocks;
+			nodes = std::log1p(estimate(form, probing).nodes);
+		}
+		init(form.data(), blocks);
+		if (!blocks) return Backend_Search;
+
+		static const SudokuSelector rules;
+		switch ((selector ? selector : &rules)->choose(featuresOfBoard(nodes))) {
+		case SudokuSelector::Engine_Learning:
+			learn = true;
+			return Backend_Search;
+		case SudokuSelector::Engine_Sat:
+			return Backend_Sat;
+		case SudokuSelector::Engine_Annealing:
+			return Backend_Annealing;
+		default:
+			return Backend_Search;
+		}
+	}
+
+	/// <summary>
+	/// get the features of the form init: the length, the ratio of givens,
+	/// and the mean count of candidates of the blanks (divided by the length), from the ranks of choices
+	/// </summary>
+	/// <param name="nodes">the log of nodes estimated, 0 if not estimated</param>
+	/// <returns>the features</returns>
+	SudokuSelector::Features FastSudoku::featuresOfBoard(double nodes) const
+	{
+		SudokuSelector::Features features;
+		features.length = formLength;
+		features.givens = formSize ? (double)finishCount / formSize : 0;
+		unsigned long long candidates = 0;
+		for (index_t i = 1; i < rank.size(); ++i) candidates += (unsigned long long)i * rank[i].size();
+		const index_t blanks = formSize - finishCount;
+		features.density = blanks ? (double)candidates / blanks / formLength : 0;
+		features.nodes = nodes;
+		return features;
+	}
+
+	/// <summary>
+	/// solve the form (init already) by the local search. the givens are kept and every block is a permutation,
+	/// when the conflicts are few the places without conflict are handed off to the exact search.
+	/// the local search can't prove no solution, so after its moves the exact search solves the whole form
+	/// </summary>
+	/// <param name="options">the options</param>
+	/// <param name="result">the solution and the statistics</param>
+	/// <returns>if solve successfully</returns>
+	bool FastSudoku::solveByAnnealing(const SolveOptions& options, SolveResult& result)
+	{
+		SolutionCache* cache = options.useCache && geometry->isStandard() ? solutionCache : nullptr;
+		SolutionCache::Key key;
+		if (cache) key = cache->makeKey(this->form);
+		if (cache && cache->find(key, result.solution)) {
+			result.fromCache = true;
+			return !result.solution.empty();
+		}
+
+		// the exact search is the SAT backend, it is the one fit for the large sudokus
+		SolveOptions exact;
+		exact.useCache = false;
+		exact.backend = Backend_Sat;
+		exact.maxNodes = annealHandOffNodes;
+		exact.deadline = limits ? deadline : clock_t::time_point::max();
+		exact.cancelToken = options.cancelToken;
+		exact.geometry = geometry;
+		FastSudoku exactSolver;
+
+		const unsigned long long maxMoves = std::min<unsigned long long>((unsigned long long)annealMovesPerBlank * (formSize - finishCount), ~0u);
+		const std::vector<save_t> givens = this->form;
+		SudokuAnnealer annealer;
+		const bool loaded = annealer.load(getView(), options.seed);
+		index_t target = options.handOffCost ? options.handOffCost : formLength / 2;
+		while (loaded) {
+			bool searching = annealer.run(target, [&](index_t moves) {
+				iterationTimes = moves;
+				return (limits && isOverLimits()) || moves >= maxMoves;
+			});
+			if (!searching) break;
+			if (annealer.getCost() == 0) {
+				result.solution = annealer.getForm();
+				break;
+			}
+
+			// the places in conflict are left to the exact search, or anneal until fewer conflicts
+			++result.restarts;
+			auto handOff = exactSolver.solve(annealer.getPartial(), exact);
+			if (handOff.isSolved()) {
+				result.solution.swap(handOff.solution);
+				break;
+			}
+			target = annealer.getCost() - 1;
+		}
+		iterationTimes = annealer.getMoves();
+
+		if (loaded && result.solution.empty() && !stopStatus) {
+			exact.maxNodes = 0;
+			auto whole = exactSolver.solve(givens, exact);
+			if (whole.isSolved()) result.solution.swap(whole.solution);
+			else if (whole.status != SolveResult::Status_NoSolution) stopStatus = whole.status;
+		}
+		if (cache && !stopStatus) cache->store(key, result.solution);
+		return !result.solution.empty();
+	}
+
+	/// <summary>
+	/// solve the form and return the solution only, the state of search is dropped
+	/// </summary>
+	/// <param name="form">the sudoku form</param>
+	/// <param name="options">the options</param>
+	/// <returns>the result</returns>
+	FastSudoku::SolveResult FastSudoku::solve(const std::vector<save_t>& form, const SolveOptions& options)
+	{
+		SolveResult result;
+		const auto tpStart = clock_t::now();
+
+		// only the form fitting the blocks can be solved
+		auto blocks = geometryOf(form.size(), options.geometry ? options.geometry : layout);
+		if (form.empty() || !blocks || (options.geometry && blocks != options.geometry)) {
+			return result;
+		}
+		if (options.variant && !options.variant->tablesOf(blocks->getLength()).valid) {
+			return result;
+		}
+
+		// the limits
+		stopStatus = 0;
+		if (options.hasLimits()) {
+			limits = &options;
+			deadline = options.deadline;
+			if (options.timeLimit > 0) {
+				auto limit = tpStart + std::chrono::duration_cast<clock_t::duration>(std::chrono::duration<double>(options.timeLimit));
+				if (limit < deadline) deadline = limit;
+			}
+		}
+
+		// the variants are only kept by the search
+		char backend = options.variant ? Backend_Search : options.backend;
+		bool learn = options.learning && !options.variant;
+		bool ready = false; // the form is init
+		if (backend == Backend_Auto) {
+			backend = selectBackend(form, blocks, options.selector ? options.selector.get() : backendSelector.get(), learn);
+			ready = true;
+		}
+		bool solved = false;
+		if (backend == Backend_Sat) {
+			solved = solveBySat(form, *blocks, options.useCache, result);
+		}
+		else {
+			if (ready) {
+				// init by the selector
+			}
+			else if (&this->form == &form) {
+				auto formCopy = form;
+				init(formCopy.data(), blocks);
+			}
+			else {
+				init(form.data(), blocks);
 			}
-		};
-
-		// recover the form
-		auto recordsCopy = records;
-		while (flashBack());
 
-		// show original
-		std::cout << "Original form:" << std::endl;
-		printForm();
-		waitPress();
+			if (contradiction) {
+				// no solution, found by init
+			}
+			else if (backend == Backend_Annealing) {
+				solved = solveByAnnealing(options, result);
+			}
+			else {
+				// the settings of search
+				valueOrder = options.valueOrder;
+				tieBreak = options.tieBreak;
+				// the nogoods are made of the places chosen, so learning only pays when the propagation between choices is strong:
+				// with the naked singles alone a contradiction of a unit is found deep, and every level looks like its cause
+				propagation = options.propagation != Propagation_Default ? options.propagation
+					: learn ? Propagation_HiddenSingles : Propagation_NakedSingles;
+				cellPolicy = options.cellPolicy;
+				valuePolicy = options.valuePolicy;
+				random.seed(options.seed);
+				learning = learn;
+				if (options.variant) variant = &options.variant->tablesOf(formLength);
+				learnedCount = backjumpCount = 0;
+				if (learning) {
+					placeDeps.assign(formSize, levels_t());
+					learnedReason.assign((size_t)formSize * (formLength + 1), levels_t());
+					watches.assign((size_t)formSize * (formLength + 1), {});
+					decisions.assign(1, literal_t(formSize, 0));
+					nogoods.clear();
+					nogoodCursor = 0;
+					maxNogoods = options.maxNogoods;
+					maxNogoodSize = options.maxNogoodSize;
+				}
+				if (options.restart != Restart_None && valueOrder != ValueOrder_Random && tieBreak != TieBreak_Random) {
+					// the same choices make the same runs
+					tieBreak = TieBreak_Random;
+				}
 
-		// start replay
-		for (auto& i : recordsCopy) {
-			if (i.type == inputForm) {
-				auto coor = translate(i.p2);
-				std::cout << "Fill " << i.p1 << " into ("
-					<< (coor.first + 1) << ',' << (coor.second + 1) << ')' << std::endl;
-				putNumberIntoForm(i.p1, i.p2);
-				changePlace.insert(i.p2);
-				printForm();
-				waitPress();
+				solved = (!variant || initVariant()) && solveWithCache(options.useCache, &result.fromCache, &result.restarts);
+				if (solved) result.solution.swap(this->form);
+				result.nogoods = learnedCount;
+				result.backjumps = backjumpCount;
 			}
 		}
-		records.swap(recordsCopy);
 
-		// show finish
-		std::cout << "Final form:" << std::endl;
-		printForm();
-		waitPress();
+		if (solved) {
+			result.status = SolveResult::Status_Solved;
+		}
+		else {
+			result.solution.clear();
+			result.status = stopStatus ? stopStatus : SolveResult::Status_NoSolution;
+		}
+		limits = nullptr;
+		stopStatus = 0;
+		learning = false;
+		variant = nullptr;
+		valueOrder = ValueOrder_Default;
+		tieBreak = TieBreak_Default;
+		propagation = Propagation_NakedSingles;
+		cellPolicy = CellPolicy_MinimumChoices;
+		valuePolicy = ValuePolicy_SetOrder;
+		result.iterations = iterationTimes;
+		result.seconds = std::chrono::duration<double>(clock_t::now() - tpStart).count();
+
+		reset(false);
+		return result;
+	}
 
+	/// <summary>
+	/// set the cache of solutions, the same or isomorphic sudoku
+	/// will get the solution from the cache when solving
+	/// </summary>
+	/// <param name="cache">the cache, null if not use</param>
+	/// <returns>FastSudoku</returns>
+	FastSudoku& FastSudoku::setSolutionCache(SolutionCache* cache)
+	{
+		this->solutionCache = cache;
 		return *this;
 	}
 
 	/// <summary>
-	/// set the change mark
+	/// set the model choosing the backend of solve(form), and of the options whose backend is auto without a selector
 	/// </summary>
-	/// <param name="flag">new flag</param>
+	/// <param name="selector">the model, null for the rules of size</param>
 	/// <returns>FastSudoku</returns>
-	FastSudoku& FastSudoku::setMarkChange(bool flag)
+	FastSudoku& FastSudoku::setBackendSelector(std::shared_ptr<const SudokuSelector> selector)
 	{
-		markChange = flag;
+		this->backendSelector = std::move(selector);
 		return *this;
 	}
 
 	/// <summary>
-	/// init, solve and get the result.
-	/// if no solve, return empty vector
+	/// set the layout of blocks, the forms of its size are solved and played with it
 	/// </summary>
-	/// <param name="form">the sudoku form</param>
+	/// <param name="geometry">the layout, null for the standard boxes of the size</param>
 	/// <returns>FastSudoku</returns>
-	FastSudoku& FastSudoku::solve(const std::vector<save_t>& form)
+	FastSudoku& FastSudoku::setGeometry(std::shared_ptr<const SudokuGeometry> geometry)
 	{
-		if (timingMode == 1 || timingMode == 3) {
-			tpBegin = clock_t::now();
-		}
-		if (&this->form == &form) {
-			auto formCopy = form;
-			init(formCopy);
-		}
-		else {
-			init(form);
-		}
-		if (timingMode == 1) {
-			tpEnd = clock_t::now();
-		}
-		else if (timingMode == 2) {
-			tpBegin = clock_t::now();
-		}
-		if (!solve()) this->form.clear();
-		if (timingMode == 2 || timingMode == 3) {
-			tpEnd = clock_t::now();
-		}
+		this->layout = std::move(geometry);
 		return *this;
 	}
 
@@ -671,6 +2142,7 @@ namespace YYYCZ {
 		else {
 			this->init(form);
 		}
+		history.reset(this->form);
 		return *this;
 	}
 
@@ -692,9 +2164,11 @@ namespace YYYCZ {
 	std::pair<FastSudoku::save_t, std::pair<FastSudoku::save_t, FastSudoku::save_t>> FastSudoku::tip() const
 	{
 		index_t minIndex = findMinimumChoicesPlace();
-		if (minIndex == formSize || mapper[minIndex].empty()) return { -1, {-1,-1} };
+		if (minIndex == formSize || candidateMask[minIndex] == 0) return { -1, {-1,-1} };
 		auto coor = translate(minIndex);
-		return { *mapper[minIndex].begin(), coor };
+		save_t number = 1;
+		while (!((candidateMask[minIndex] >> number) & 1)) ++number;
+		return { number, coor };
 	}
 
 	/// <summary>
@@ -710,6 +2184,47 @@ namespace YYYCZ {
 		return mapper[index];
 	}
 
+	/// <summary>
+	/// get the legal numbers (can be filled) of one place as bits, bit i for number i
+	/// </summary>
+	/// <param name="row">row of place</param>
+	/// <param name="column">column of place</param>
+	/// <returns>the bits of legal numbers</returns>
+	FastSudoku::mask_t FastSudoku::getLegalMaskAt(save_t row, save_t column) const
+	{
+		index_t index = this->translate(row, column);
+		if (index >= formSize) return 0;
+		return candidateMask[index];
+	}
+
+	/// <summary>
+	/// judge if the place is original
+	/// </summary>
+	/// <param name="index">index of place</param>
+	/// <returns>if is original</returns>
+	bool FastSudoku::isOriginal(index_t index) const
+	{
+		return index < formSize && ((givenBits[index >> 6] >> (index & 63)) & 1);
+	}
+
+	/// <summary>
+	/// get the read only view of the board, no copy and no hash
+	/// </summary>
+	/// <returns>view, empty if not init</returns>
+	FastSudoku::BoardView FastSudoku::getView() const
+	{
+		BoardView view;
+		if (!__CheckIfInit()) return view;
+		view.values = form.data();
+		view.candidates = candidateMask.data();
+		view.givens = givenBits.data();
+		view.dim = formDim;
+		view.length = formLength;
+		view.size = formSize;
+		view.geometry = geometry.get();
+		return view;
+	}
+
 	/// <summary>
 	/// check if the sudoku is already init
 	/// </summary>
@@ -728,24 +2243,83 @@ namespace YYYCZ {
 	/// <returns>if fill successfully</returns>
 	bool FastSudoku::tryFill(save_t number, save_t row, save_t column)
 	{
-		recordMode = true;
 		index_t index = this->translate(row, column);
 		if (index >= formSize || mapper[index].find(number) == mapper[index].end()) {
 			return false;
 		}
-		save();
+		// the history keeps the versions, no need to record the operates
+		if (history.getFormSize() != formSize) history.reset(form);
+		recordMode = false;
 		putNumberIntoForm(number, index);
+		history.apply(index, number);
 		if (showAfterFill) printForm();
 		return true;
 	}
 
 	/// <summary>
-	/// undo the last operate. need to open the record mode
+	/// make the form the same as now version of history, from the version before.
+	/// only the places different are changed
+	/// </summary>
+	/// <param name="from">the version of the form now</param>
+	void FastSudoku::syncHistory(SudokuHistory::version_t from)
+	{
+		auto changes = history.diff(from, history.getVersion());
+		recordMode = false;
+
+		// remove first, so the numbers put later are free
+		for (auto& change : changes) {
+			if (form[change.first] != 0) removeNumberFromForm(change.first);
+		}
+		for (auto& change : changes) {
+			if (change.second != 0) putNumberIntoForm(change.second, change.first);
+		}
+		assert(checkCandidates());
+	}
+
+	/// <summary>
+	/// check the candidates are exact, the same as a fresh init of the form:
+	/// a blank has just the numbers free in its row, column and block, in the rank of its count, and a filled place has none
+	/// </summary>
+	/// <returns>if exact</returns>
+	bool FastSudoku::checkCandidates() const
+	{
+		for (index_t index = 0; index < formSize; ++index) {
+			mask_t free = 0;
+			index_t count = 0;
+			for (save_t i = 1; form[index] == 0 && i <= (save_t)formLength; ++i) {
+				if (!isNumberFree(i, index)) continue;
+				if (mapper[index].count(i) == 0) return false;
+				free |= bitOf(i);
+				++count;
+			}
+			if (mapper[index].size() != count || rank[count].count(index) == 0) return false;
+			if (formLength < 64 && candidateMask[index] != free) return false;
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// undo the last fill or erase
 	/// </summary>
 	/// <returns>if undo</returns>
 	bool FastSudoku::undo()
 	{
-		bool res = flashBack();
+		auto from = history.getVersion();
+		bool res = history.undo();
+		if (res) syncHistory(from);
+		if (showAfterFill) printForm();
+		return res;
+	}
+
+	/// <summary>
+	/// redo the fill or erase undone
+	/// </summary>
+	/// <returns>if redo</returns>
+	bool FastSudoku::redo()
+	{
+		auto from = history.getVersion();
+		bool res = history.redo();
+		if (res) syncHistory(from);
 		if (showAfterFill) printForm();
 		return res;
 	}
@@ -759,52 +2333,62 @@ namespace YYYCZ {
 	FastSudoku& FastSudoku::erase(save_t row, save_t column) {
 		// check if could be erase
 		index_t index = translate(row, column);
-		if (index >= formSize || form[index] == 0 || original.count(index) != 0)
+		if (index >= formSize || form[index] == 0 || isOriginal(index))
 			return *this;
 
-		// flash back until find this number
-		bool mc = markChange;
-		markChange = false;
-		std::vector<SudokuOperate> backup;
-		while (!records.empty()) {
-			if (records.back().type == inputForm) {
-				if (records.back().p2 == index) {
-					flashBack();
-					break;
-				}
-				else {
-					backup.push_back(records.back());
-				}
-			}
-			undoOperate();
-		}
-
-		// push others
-		recordMode = true;
-		for (auto itr = backup.rbegin(); itr != backup.rend(); ++itr) {
-			save();
-			putNumberIntoForm(itr->p1, itr->p2);
-		}
-
-		// mark change
-		markChange = mc;
-		if (markChange) {
-			changePlace.insert(index);
-		}
-
+		// only the place and its peers change, and undo can put the number back
+		if (history.getFormSize() != formSize) history.reset(form);
+		recordMode = false;
+		removeNumberFromForm(index);
+		history.apply(index, 0);
 		return *this;
 	}
 
 	/// <summary>
-	/// restart the game
+	/// restart the game, redo can go back
 	/// </summary>
 	/// <returns>FastSudoku</returns>
 	FastSudoku& FastSudoku::restart()
 	{
-		while (flashBack());
+		auto from = history.getVersion();
+		if (history.restart()) syncHistory(from);
 		return *this;
 	}
 
+	/// <summary>
+	/// name now state of the game, to come back later
+	/// </summary>
+	/// <param name="name">name of checkpoint</param>
+	/// <returns>FastSudoku</returns>
+	FastSudoku& FastSudoku::setCheckpoint(const std::string& name)
+	{
+		if (history.getFormSize() != formSize) history.reset(form);
+		history.setCheckpoint(name);
+		return *this;
+	}
+
+	/// <summary>
+	/// go back to a checkpoint, the moves after it are kept in the history
+	/// </summary>
+	/// <param name="name">name of checkpoint</param>
+	/// <returns>if the checkpoint exists</returns>
+	bool FastSudoku::checkout(const std::string& name)
+	{
+		auto from = history.getVersion();
+		if (!history.checkout(name)) return false;
+		syncHistory(from);
+		return true;
+	}
+
+	/// <summary>
+	/// get the history of the game
+	/// </summary>
+	/// <returns>history</returns>
+	const SudokuHistory& FastSudoku::getHistory() const
+	{
+		return history;
+	}
+
 	/// <summary>
 	/// judge if the game is finish
 	/// </summary>
@@ -827,6 +2411,331 @@ namespace YYYCZ {
 		return solve();
 	}
 
+	/// <summary>
+	/// read the checkpoint of enumerating
+	/// </summary>
+	/// <param name="file">the file</param>
+	/// <returns>false if can't read or it is bad</returns>
+	bool FastSudoku::EnumerateCheckpoint::read(const std::string& file)
+	{
+		std::ifstream in(file);
+		std::string magic, key;
+		int version = 0;
+		if (!(in >> magic >> version) || magic != "sudoku-enumerate" || version != 1) return false;
+
+		size_t size = 0, steps = 0;
+		if (!(in >> key >> size) || key != "form" || size > (1u << 24)) return false;
+		form.assign(size, 0);
+		for (auto& number : form) in >> number;
+		if (!(in >> key >> solutions) || key != "solutions") return false;
+		if (!(in >> key >> nodes) || key != "nodes") return false;
+		if (!(in >> key >> sinkPosition) || key != "sink") return false;
+		if (!(in >> key >> finished) || key != "finished") return false;
+		if (!(in >> key >> descend) || key != "descend") return false;
+		if (!(in >> key >> steps) || key != "path" || steps > size) return false;
+		path.assign(steps, { 0, 0 });
+		for (auto& step : path) in >> step.first >> step.second;
+		return !in.fail();
+	}
+
+	/// <summary>
+	/// write the checkpoint of enumerating into a temporary file, then rename it,
+	/// so a crash when writing won't break the last checkpoint
+	/// </summary>
+	/// <param name="file">the file</param>
+	/// <returns>if write successfully</returns>
+	bool FastSudoku::EnumerateCheckpoint::write(const std::string& file) const
+	{
+		const std::string temporary = file + ".tmp";
+		{
+			std::ofstream out(temporary, std::ios::trunc);
+			if (!out) return false;
+			out << "sudoku-enumerate 1\n";
+			out << "form " << form.size();
+			for (auto number : form) out << ' ' << number;
+			out << "\nsolutions " << solutions << "\nnodes " << nodes << "\nsink " << sinkPosition
+				<< "\nfinished " << finished << "\ndescend " << descend << "\npath " << path.size() << '\n';
+			for (auto& step : path) out << step.first << ' ' << step.second << '\n';
+			out.flush();
+			if (!out) return false;
+		}
+		std::error_code error;
+		std::filesystem::rename(temporary, file, error);
+		return !error;
+	}
+
+	/// <summary>
+	/// enumerate all the solutions of a sudoku, no limit and no checkpoint
+	/// </summary>
+	/// <param name="form">the sudoku form</param>
+	/// <param name="sink">called with every solution, false to stop</param>
+	/// <returns>the result</returns>
+	FastSudoku::EnumerateResult FastSudoku::enumerate(const std::vector<save_t>& form, const SolutionSink& sink)
+	{
+		return enumerate(form, sink, EnumerateOptions());
+	}
+
+	/// <summary>
+	/// enumerate all the solutions of the form, every solution is given to the sink and not kept.
+	/// the search is a loop on a stack of levels and the records of operates, not recursion,
+	/// so the stack (the place and the choices tried of every level) can be saved and replayed to resume.
+	/// the place is the lowest one with minimum choices and the numbers are ascending, the same after resuming
+	/// </summary>
+	/// <param name="form">the sudoku form</param>
+	/// <param name="sink">called with every solution, false to stop</param>
+	/// <param name="options">the options</param>
+	/// <returns>the result</returns>
+	FastSudoku::EnumerateResult FastSudoku::enumerate(const std::vector<save_t>& form, const SolutionSink& sink, const EnumerateOptions& options)
+	{
+		EnumerateResult result;
+		const auto tpStart = clock_t::now();
+		if (form.empty() || !geometryOf(form.size(), layout)) return result;
+		const std::vector<save_t> givens = form;
+
+		// the checkpoint to continue, begin from the start if no checkpoint
+		EnumerateCheckpoint checkpoint;
+		if (options.resume && !options.checkpointFile.empty() && checkpoint.read(options.checkpointFile)) {
+			if (checkpoint.form != givens) {
+				result.status = EnumerateResult::Status_BadCheckpoint;
+				return result;
+			}
+			result.resumed = true;
+		}
+		unsigned long long solutions = checkpoint.solutions, nodes = checkpoint.nodes;
+		if (checkpoint.finished) {
+			result.status = EnumerateResult::Status_Finished;
+			result.solutions = solutions;
+			result.nodes = nodes;
+			return result;
+		}
+
+		init(givens);
+		tieBreak = TieBreak_LowestIndex;
+		recordMode = true;
+
+		// a level of search: the place, its numbers, and the count tried. the last tried is in the form
+		struct Level {
+			index_t place;
+			std::vector<save_t> choices;
+			index_t next;
+		};
+		std::vector<Level> levels;
+		bool descend = !contradiction && fillSingles(); // the last choice is put and not searched yet
+
+		// replay the levels of checkpoint, every level must be the same as before
+		bool bad = false;
+		for (size_t i = 0; i < checkpoint.path.size() && !bad; ++i) {
+			Level level{ checkpoint.path[i].first, {}, checkpoint.path[i].second };
+			if (!descend || finishCount == formSize || findMinimumChoicesPlace() != level.place) {
+				bad = true;
+				break;
+			}
+			choicesOf(level.place, level.choices);
+			if (level.next == 0 || level.next > level.choices.size()) {
+				bad = true;
+				break;
+			}
+			save();
+			descend = putNumberIntoForm(level.choices[level.next - 1], level.place) && fillSingles();
+			levels.push_back(std::move(level));
+		}
+		if (result.resumed) {
+			if (bad || (checkpoint.descend && !descend)) {
+				result.status = EnumerateResult::Status_BadCheckpoint;
+				tieBreak = TieBreak_Default;
+				reset(false);
+				return result;
+			}
+			descend = checkpoint.descend;
+		}
+
+		// save the state between two nodes
+		auto lastSave = clock_t::now();
+		const auto saveEvery = std::chrono::duration_cast<clock_t::duration>(std::chrono::duration<double>(options.checkpointSeconds));
+		const auto deadline = options.timeLimit > 0
+			? tpStart + std::chrono::duration_cast<clock_t::duration>(std::chrono::duration<double>(options.timeLimit))
+			: clock_t::time_point::max();
+		// the checkpoint is not saved if the sink can't be flushed, its position would be of the solutions lost
+		bool stopping = false, sinkFailed = false;
+		auto saveState = [&](bool finished) {
+			if (options.checkpointFile.empty()) return;
+			EnumerateCheckpoint state;
+			state.form = givens;
+			state.solutions = solutions;
+			state.nodes = nodes;
+			if (options.flushSink && !options.flushSink(state.sinkPosition)) {
+				sinkFailed = stopping = true;
+				return;
+			}
+			state.finished = finished;
+			state.descend = descend;
+			for (auto& level : levels) state.path.emplace_back(level.place, level.next);
+			if (state.write(options.checkpointFile)) ++result.checkpoints;
+			lastSave = clock_t::now();
+		};
+
+		index_t poll = 0;
+		while (true) {
+			if (++poll == 256) {
+				poll = 0;
+				const auto now = clock_t::now();
+				if (now >= deadline || (options.cancelToken && options.cancelToken->load(std::memory_order_relaxed))) stopping = true;
+				else if (!options.checkpointFile.empty() && now - lastSave >= saveEvery) saveState(false);
+			}
+			if (stopping) {
+				saveState(false);
+				result.status = EnumerateResult::Status_Stopped;
+				break;
+			}
+
+			// a solution, or a new level
+			if (descend) {
+				if (finishCount == formSize) {
+					++solutions;
+					descend = false;
+					if ((sink && !sink(this->form)) || (options.maxSolutions && solutions >= options.maxSolutions)) stopping = true;
+					continue;
+				}
+				Level level{ findMinimumChoicesPlace(), {}, 0 };
+				choicesOf(level.place, level.choices);
+				levels.push_back(std::move(level));
+			}
+			if (levels.empty()) {
+				saveState(true);
+				result.status = EnumerateResult::Status_Finished;
+				break;
+			}
+
+			// take back the last number of the level, and try the next one
+			Level& level = levels.back();
+			if (level.next) flashBack();
+			if (level.next == level.choices.size()) {
+				levels.pop_back();
+				continue;
+			}
+			save();
+			++nodes;
+			descend = putNumberIntoForm(level.choices[level.next++], level.place) && fillSingles();
+		}
+
+		if (sinkFailed) result.status = EnumerateResult::Status_SinkFailed;
+		result.solutions = solutions;
+		result.nodes = nodes;
+		result.seconds = std::chrono::duration<double>(clock_t::now() - tpStart).count();
+		tieBreak = TieBreak_Default;
+		reset(false);
+		return result;
+	}
+
+	/// <summary>
+	/// estimate the size of the full search tree by 64 probes
+	/// </summary>
+	/// <param name="form">the sudoku form</param>
+	/// <returns>the result</returns>
+	FastSudoku::EstimateResult FastSudoku::estimate(const std::vector<save_t>& form)
+	{
+		return estimate(form, EstimateOptions());
+	}
+
+	/// <summary>
+	/// estimate the size of search tree by Knuth's random probes:
+	/// a probe goes down from the root by random choices, at every level the place is the one with minimum choices
+	/// as solve() chooses, and the product of the counts of choices on the way is the count of nodes at that depth.
+	/// the sum of products is an unbiased estimate of the nodes of the tree, the mean of probes is the result.
+	/// it is the whole tree (the search for all the solutions), a solvable sudoku is usually solved in a small part of it.
+	/// the time is the nodes times the time of a node in the probes, which do the same filling as the search
+	/// </summary>
+	/// <param name="form">the sudoku form</param>
+	/// <param name="options">the options</param>
+	/// <returns>the result</returns>
+	FastSudoku::EstimateResult FastSudoku::estimate(const std::vector<save_t>& form, const EstimateOptions& options)
+	{
+		if (&this->form == &form) {
+			auto formCopy = form;
+			return estimate(formCopy, options);
+		}
+		EstimateResult result;
+		const auto tpStart = clock_t::now();
+		auto blocks = geometryOf(form.size(), options.geometry ? options.geometry : layout);
+		if (form.empty() || !blocks || (options.geometry && blocks != options.geometry)) return result;
+		result.valid = true;
+
+		init(form.data(), blocks);
+		recordMode = true;
+		const auto deadline = options.timeLimit > 0
+			? tpStart + std::chrono::duration_cast<clock_t::duration>(std::chrono::duration<double>(options.timeLimit))
+			: clock_t::time_point::max();
+
+		// the root may be solved or dead by the singles
+		std::mt19937 generator(options.seed);
+		std::vector<save_t> choices;
+		double sum = 0, squares = 0;
+		unsigned long long steps = 0;
+		const bool alive = !contradiction && fillSingles();
+		const index_t probes = std::max<index_t>(1, options.probes);
+		while (result.probes < probes && (result.probes == 0 || clock_t::now() < deadline)) {
+			double width = 1, nodes = 0;
+			index_t depth = 0;
+			bool descend = alive;
+			while (descend && finishCount != formSize) {
+				const index_t place = findMinimumChoicesPlace();
+				choicesOf(place, choices);
+				if (choices.empty()) break;
+				width *= choices.size();
+				nodes += width;
+				save();
+				++depth;
+				++steps;
+				descend = putNumberIntoForm(choices[generator() % choices.size()], place) && fillSingles();
+			}
+			while (depth--) flashBack();
+
+			sum += nodes;
+			squares += nodes * nodes;
+			++result.probes;
+		}
+
+		// the root is a node of the search too
+		const double mean = sum / result.probes;
+		result.nodes = 1 + mean;
+		result.deviation = result.probes > 1
+			? std::sqrt(std::max(0.0, squares / result.probes - mean * mean) / (result.probes - 1))
+			: 0;
+		result.probeSeconds = std::chrono::duration<double>(clock_t::now() - tpStart).count();
+		result.treeSeconds = result.nodes * result.probeSeconds / (steps + result.probes);
+		reset(false);
+		return result;
+	}
+
+	/// <summary>
+	/// get the features of a sudoku for the selector
+	/// </summary>
+	/// <param name="form">the sudoku form</param>
+	/// <param name="probes">the probes of estimating the nodes, 0 for no estimate</param>
+	/// <param name="geometry">the blocks, null for the layout set or the standard boxes of the size</param>
+	/// <returns>the features, all 0 if the size of form is not a sudoku</returns>
+	SudokuSelector::Features FastSudoku::measure(const std::vector<save_t>& form, index_t probes, const std::shared_ptr<const SudokuGeometry>& geometry)
+	{
+		if (&this->form == &form) {
+			auto formCopy = form;
+			return measure(formCopy, probes, geometry);
+		}
+		auto blocks = geometryOf(form.size(), geometry ? geometry : layout);
+		if (form.empty() || !blocks) return SudokuSelector::Features();
+
+		double nodes = 0;
+		if (probes) {
+			EstimateOptions probing;
+			probing.probes = probes;
+			probing.geometry = blocks;
+			nodes = std::log1p(estimate(form, probing).nodes);
+		}
+		init(form.data(), blocks);
+		auto features = featuresOfBoard(nodes);
+		reset(false);
+		return features;
+	}
+
 	/// <summary>
 	/// generate a sudoku (may not unique solve)
 	/// </summary>
@@ -841,8 +2750,9 @@ namespace YYYCZ {
 			return false;
 		}
 
-		// set random seed
-		srand(time(nullptr) * (1 + maxGenerateTimes));
+		// set random seed, the count of calls keeps the sudokus generated in one second different
+		static unsigned int generateCalls = 0;
+		srand(time(nullptr) * (1 + maxGenerateTimes) + 7919 * generateCalls++);
 
 		// load a empty form
 		std::vector<save_t> emptyForm;
@@ -955,7 +2865,7 @@ namespace YYYCZ {
 	}
 
 	/// <summary>
-	/// get the dimension of form
+	/// get the dimension of form, 0 if the blocks are not square boxes
 	/// </summary>
 	/// <returns>dimension</returns>
 	FastSudoku::index_t FastSudoku::getFormDimension() const
@@ -980,4 +2890,13 @@ namespace YYYCZ {
 	{
 		return this->formSize;
 	}
+
+	/// <summary>
+	/// get the blocks of the form
+	/// </summary>
+	/// <returns>the layout, null if not init</returns>
+	const SudokuGeometry* FastSudoku::getGeometry() const
+	{
+		return this->geometry.get();
+	}
 }
\ No newline at end of file
@@ -3,13 +3,24 @@
 #ifndef __YYYCZ_FAST_SUDOKU_H__
 #define __YYYCZ_FAST_SUDOKU_H__
 
+#include "SudokuHistory.h"
+#include "SudokuGeometry.h"
+#include "SudokuVariant.h"
+#include "SudokuSelector.h"
+#include <atomic>
 #include <deque>
 #include <vector>
 #include <chrono>
 #include <functional>
+#include <iosfwd>
+#include <memory>
+#include <random>
 #include <unordered_set>
+#include <string>
 
 namespace YYYCZ {
+	class SolutionCache;
+
 	// a tool class can fastly solve the sudoku.
 	// also can be used to play sudoku!
 	// NOT THREAD SAFE
@@ -18,6 +29,160 @@ namespace YYYCZ {
 		using save_t = int;
 		using index_t = unsigned int;
 		using clock_t = std::chrono::high_resolution_clock;
+		using mask_t = unsigned long long; // bit i for number i, the numbers bigger than 63 are not kept
+
+		// the result of solving, only the solution and the statistics, without the state of search
+		struct SolveResult {
+			static constexpr char Status_Solved = 0; // the solution is found
+			static constexpr char Status_NoSolution = 1; // no solution
+			static constexpr char Status_Invalid = 2; // the size of form is not a sudoku
+			static constexpr char Status_BudgetExhausted = 3; // stopped by the deadline or the max nodes
+			static constexpr char Status_Cancelled = 4; // stopped by the cancel token
+
+			char status = Status_Invalid; // the status
+			std::vector<save_t> solution; // the solution, empty if not solved
+			index_t iterations = 0; // the times of iteration
+			double seconds = 0; // the time of solving
+			bool fromCache = false; // if the solution is from the cache
+			index_t restarts = 0; // the times of restart, or the hand-offs of the local search
+			index_t nogoods = 0; // the count of nogoods learned
+			index_t backjumps = 0; // the times of jumping over a level
+
+			bool isSolved() const { return status == Status_Solved; }
+		};
+
+		// the settings of search
+		static constexpr char ValueOrder_Default = 0; // the order of the candidates set
+		static constexpr char ValueOrder_Ascending = 1;
+		static constexpr char ValueOrder_Descending = 2;
+		static constexpr char ValueOrder_Random = 3; // shuffled by the seed
+		static constexpr char TieBreak_Default = 0; // any of the places
+		static constexpr char TieBreak_LowestIndex = 1;
+		static constexpr char TieBreak_HighestIndex = 2;
+		static constexpr char TieBreak_Random = 3; // chosen by the seed
+		static constexpr char Propagation_Default = -1; // the naked singles for the search, the hidden singles for learning
+		static constexpr char Propagation_NakedSingles = 0; // fill the places with one choice
+		static constexpr char Propagation_HiddenSingles = 1; // also the number with one place in a row, column or block
+		static constexpr char CellPolicy_MinimumChoices = 0; // a place with minimum choices, chosen by the tie break
+		static constexpr char CellPolicy_Degree = 1; // in the places with minimum choices, the one with most blank peers
+		static constexpr char ValuePolicy_SetOrder = 0; // the order of numbers set by the value order
+		static constexpr char ValuePolicy_LeastConstraining = 1; // the number removing the fewest choices of peers first
+		static constexpr char ValuePolicy_Frequency = 2; // the number filled most on the board first
+		static constexpr char Restart_None = 0;
+		static constexpr char Restart_Luby = 1; // the nodes of runs are base * 1, 1, 2, 1, 1, 2, 4, ...
+		static constexpr char Restart_Geometric = 2; // the nodes of runs are base * factor ^ n
+		static constexpr char Backend_Search = 0; // the search on the board
+		static constexpr char Backend_Sat = 1; // encoded as CNF and solved by the CDCL solver, for the large sudokus
+		static constexpr char Backend_Annealing = 2; // the local search, for filling the huge sudokus with few givens
+		static constexpr char Backend_Auto = 3; // chosen by the selector from the features of the form
+
+		// the options of solving
+		struct SolveOptions {
+			bool useCache = true; // if use the cache of solutions set
+			double timeLimit = 0; // the seconds of solving at most, 0 for no limit
+			clock_t::time_point deadline = clock_t::time_point::max(); // the time to stop
+			index_t maxNodes = 0; // the times of iteration at most, 0 for no limit
+			const std::atomic<bool>* cancelToken = nullptr; // stop when it is true, null if not use
+			index_t pollInterval = 256; // check the clock and the token every N nodes
+			char valueOrder = 0; // the order to try the numbers, ValueOrder_X
+			char tieBreak = 0; // the place chosen in the places with minimum choices, TieBreak_X
+			char propagation = Propagation_Default; // the level of propagation, Propagation_X
+			char cellPolicy = 0; // the policy to choose the place to try, CellPolicy_X
+			char valuePolicy = 0; // the policy to order the numbers to try, ValuePolicy_X
+			unsigned int seed = 0; // the seed of random choices
+			char restart = 0; // give up the run and search again with other random choices, Restart_X
+			index_t restartBase = 100; // the nodes of the first run
+			double restartFactor = 1.5; // the growth of runs for the geometric restart
+			bool learning = false; // explain the conflicts, jump back to the cause and learn the nogoods (with the hidden singles by default)
+			index_t maxNogoods = 1 << 14; // the nogoods kept at most, the oldest is forgotten
+			index_t maxNogoodSize = 32; // the longer nogoods are not kept
+			char backend = 0; // the way to solve, Backend_X. the settings of search are not used by the SAT and local search
+			index_t handOffCost = 0; // the local search hands off to the exact search at this count of conflicts, 0 for half the length
+			std::shared_ptr<const SudokuGeometry> geometry; // the blocks, null for the layout set or the standard boxes of the size
+			std::shared_ptr<const SudokuVariant> variant; // the rules besides the units, null if none. only the search backend, without learning
+			std::shared_ptr<const SudokuSelector> selector; // the model of Backend_Auto, null for the selector set (or the rules of size)
+
+			bool hasLimits() const { return timeLimit > 0 || deadline != clock_t::time_point::max() || maxNodes || cancelToken || restart; }
+		};
+
+		// a read only view of the board without copy, valid until the sudoku changes
+		struct BoardView {
+			const save_t* values = nullptr; // the numbers of places, 0 for blank
+			const mask_t* candidates = nullptr; // the numbers can be filled of places
+			const mask_t* givens = nullptr; // bit (index % 64) of givens[index / 64] for the original places
+			index_t dim = 0; // the dimension of the form, 0 if the blocks are not square boxes
+			index_t length = 0; // the length of the form
+			index_t size = 0; // the size of the form
+			const SudokuGeometry* geometry = nullptr; // the blocks of the form
+
+			save_t value(index_t index) const { return values[index]; }
+			mask_t candidatesAt(index_t index) const { return candidates[index]; }
+			bool isGiven(index_t index) const { return (givens[index >> 6] >> (index & 63)) & 1; }
+			bool canFill(index_t index, save_t number) const { return (candidates[index] >> number) & 1; }
+			static index_t countOf(mask_t mask) { index_t count = 0; for (; mask; mask &= mask - 1) ++count; return count; }
+		};
+
+		// the settings of enumerating all the solutions
+		struct EnumerateOptions {
+			unsigned long long maxSolutions = 0; // stop after N solutions, 0 for all
+			double timeLimit = 0; // the seconds of enumerating at most, 0 for no limit
+			const std::atomic<bool>* cancelToken = nullptr; // stop when it is true, null if not use
+			std::string checkpointFile; // the file to save the state, empty if not save
+			double checkpointSeconds = 60; // the seconds between two checkpoints
+			bool resume = false; // continue from the checkpoint file if it is of the same form
+			std::function<bool(unsigned long long& position)> flushSink; // flush the sink before a checkpoint and give its position,
+				// false if the sink failed (no checkpoint is saved, and enumerating stops), null if not use
+		};
+
+		// the result of enumerating, the counts include the ones before resuming
+		struct EnumerateResult {
+			static constexpr char Status_Finished = 0; // all the solutions are enumerated
+			static constexpr char Status_Stopped = 1; // stopped by the sink, the limits or the cancel token
+			static constexpr char Status_Invalid = 2; // the size of form is not a sudoku
+			static constexpr char Status_BadCheckpoint = 3; // the checkpoint can't be read or is not of the form
+			static constexpr char Status_SinkFailed = 4; // the sink failed to flush, the checkpoint after the last good one is not saved
+
+			char status = Status_Invalid; // the status
+			unsigned long long solutions = 0; // the count of solutions
+			unsigned long long nodes = 0; // the count of choices tried
+			index_t checkpoints = 0; // the times of saving
+			bool resumed = false; // if continued from the checkpoint
+			double seconds = 0; // the time of this run
+		};
+
+		// the state of enumerating, saved as text, to resume after a crash
+		struct EnumerateCheckpoint {
+			std::vector<save_t> form; // the form enumerated
+			unsigned long long solutions = 0; // the count of solutions before
+			unsigned long long nodes = 0; // the count of choices tried before
+			unsigned long long sinkPosition = 0; // the position of sink, such as the bytes written
+			bool finished = false; // all the solutions are enumerated
+			bool descend = false; // the last choice is not searched yet
+			std::vector<std::pair<index_t, index_t>> path; // the place and the count of choices tried of every level
+
+			bool read(const std::string& file);
+			bool write(const std::string& file) const; // into a temporary file, then renamed
+		};
+		using SolutionSink = std::function<bool(const std::vector<save_t>& solution)>; // false to stop
+
+		// the settings of estimating the size of search tree
+		struct EstimateOptions {
+			index_t probes = 64; // the random paths from the root
+			double timeLimit = 0; // the seconds of probing at most, 0 for no limit (at least one probe)
+			unsigned int seed = 0; // the seed of random choices
+			std::shared_ptr<const SudokuGeometry> geometry; // the blocks, null for the layout set or the standard boxes of the size
+		};
+
+		// the estimated size of the full search tree (all the solutions, as enumerate searches).
+		// it is not the cost of solving: the first solution is usually found far earlier
+		struct EstimateResult {
+			bool valid = false; // false if the size of form is not a sudoku
+			double nodes = 0; // the estimated count of nodes of the full tree
+			double treeSeconds = 0; // the estimated time of searching the full tree, by the time of a node in the probes
+			double deviation = 0; // the standard error of the nodes estimated
+			index_t probes = 0; // the count of probes done
+			double probeSeconds = 0; // the time of probing
+		};
 
 	private:
 		constexpr static char inputForm = 0; // input the number to the sudoku form
@@ -25,6 +190,9 @@ namespace YYYCZ {
 		constexpr static char moveRank = 2; // move the item from the rank
 		constexpr static char clearRank = 3; // clear the item from the rank
 		constexpr static char archivePoint = 4; // do nothing, just the archive point
+		constexpr static char removeForm = 5; // remove the number from the sudoku form
+		constexpr static char restoreMapper = 6; // put the number back into the mapper
+		constexpr static char raiseRank = 7; // move the item up the rank
 
 		// a struct to record the operate
 		struct SudokuOperate {
@@ -35,35 +203,96 @@ namespace YYYCZ {
 
 		// For solve
 		bool recordMode = false; // if to record operate
-		index_t formDim = 0; // the dimension of the form
+		index_t formDim = 0; // the dimension of the form, 0 if the blocks are not square boxes
 		index_t formSize = 0; // the size of the form
 		index_t formLength = 0; // the length of the form
 		index_t finishCount = 0; // the count of the finish place
+		bool contradiction = false; // the givens conflict (a number twice in a unit, or a place can't be filled), found by init
 		index_t iterationTimes = 0; // the times of iteration
 		std::vector<save_t> form; // the form of sudoku
 		std::vector<std::unordered_set<save_t>> mapper; // the number of the place can be filled
 		std::vector<std::unordered_set<index_t>> rank; // help to find minimum choices' place
 		std::unordered_set<index_t> original; // record the original form place where has number
+		std::vector<index_t> unitCounter; // count of every number in every row, column and block
+		std::vector<index_t> unitHolder; // a place of every number in every row, column and block, valid if counted
+		std::vector<mask_t> candidateMask; // the same as mapper, as bits
+		std::vector<mask_t> givenBits; // the bits of the original places
 		std::deque<SudokuOperate> records; // record the operates of history
 
+		// For geometry
+		std::shared_ptr<const SudokuGeometry> layout; // the layout set, null for the standard boxes of the size
+		std::shared_ptr<const SudokuSelector> backendSelector; // choose the backend of solve(form), null for the rules of size
+		std::shared_ptr<const SudokuGeometry> geometry; // the blocks of the form now
+		const SudokuGeometry::index_t* blockTable = nullptr; // the block of every place
+		const SudokuGeometry::index_t* placeTable = nullptr; // the places of every block, block * length + i
+
 		// For show
 		bool markChange = false; // if record the place changed
 		std::unordered_set<index_t> changePlace; // record the place changed
 
 		// For play
 		bool showAfterFill = true; // if show after fill
+		SudokuHistory history; // the versions of the game, for undo, redo and checkpoints
 
 		// For timing
 		char timingMode = 0; // the mode of timing
 		decltype(clock_t::now()) tpBegin; // time point of begin
 		decltype(clock_t::now()) tpEnd; // time point of end
 
+		// For cache
+		SolutionCache* solutionCache = nullptr; // the cache of solutions, null if not use
+
+		// For limits of solving
+		const SolveOptions* limits = nullptr; // the limits of now solving, null if no limit
+		clock_t::time_point deadline; // the deadline of now solving
+		char stopStatus = 0; // why the solving stopped, 0 if not stopped
+		static constexpr char stopRestart = -1; // the status to give up the run and restart
+
+		// For local search
+		static constexpr index_t annealMovesPerBlank = 50000; // the moves of local search at most, then the exact search decides
+		static constexpr index_t annealHandOffNodes = 100000; // the nodes of a hand-off at most
+
+		// For search
+		char valueOrder = ValueOrder_Default; // the order to try the numbers
+		char tieBreak = TieBreak_Default; // the place chosen in the places with minimum choices
+		char propagation = Propagation_NakedSingles; // the level of propagation
+		char cellPolicy = CellPolicy_MinimumChoices; // the policy to choose the place to try
+		char valuePolicy = ValuePolicy_SetOrder; // the policy to order the numbers to try
+		mutable std::mt19937 random; // for the random choices
+
+		// For learning, a conflict is explained by the decision levels causing it
+		using levels_t = std::vector<index_t>; // the decision levels, sorted
+		using literal_t = std::pair<index_t, save_t>; // the place is the number
+		struct Nogood {
+			std::vector<literal_t> literals; // the decisions can't be made together
+			index_t watch[2] = { 0, 0 }; // the literals watched
+			unsigned int stamp = 0; // changed when the slot is reused
+		};
+		bool learning = false; // if learning mode
+		std::vector<levels_t> placeDeps; // the levels causing the number of a place
+		std::vector<levels_t> learnedReason; // the levels causing a number erased by a nogood, place * (length + 1) + number
+		std::vector<literal_t> decisions; // the decision of every level
+		std::vector<Nogood> nogoods; // the nogoods learned
+		std::vector<std::vector<std::pair<index_t, unsigned int>>> watches; // the nogoods (and stamps) watching a literal
+		index_t nogoodCursor = 0; // the slot of next nogood
+		index_t maxNogoods = 0; // the nogoods kept at most
+		index_t maxNogoodSize = 0; // the longer nogoods are not kept
+		index_t learnedCount = 0; // the count of nogoods learned
+		index_t backjumpCount = 0; // the times of jumping over a level
+		index_t restartAt = 0; // the iteration times to restart, 0 if not restart
+
+		// For variant, the rules besides the units
+		const SudokuVariant::Tables* variant = nullptr; // the rules of now solving, null if none
+
 		// Check
 		bool __CheckIfInit() const;
 
 		// Base Operate
+		static mask_t bitOf(save_t number) { return number < 64 ? 1ull << number : 0; }
 		void doOperate(const SudokuOperate& op);
 		void undoOperate();
+		void countNumber(save_t number, index_t index, int delta);
+		bool isNumberFree(save_t number, index_t index) const;
 
 		// Coordinate transform
 		index_t translate(save_t i, save_t j) const;
@@ -72,6 +301,7 @@ namespace YYYCZ {
 		save_t getBlock(save_t i, save_t j) const;
 		save_t getBlock(const std::pair<save_t, save_t>& coordinate) const;
 		std::pair<save_t, save_t> blockAt(save_t block, save_t i) const;
+		std::shared_ptr<const SudokuGeometry> geometryOf(size_t size, const std::shared_ptr<const SudokuGeometry>& preferred) const;
 
 		// Local Operate
 	protected:
@@ -85,15 +315,84 @@ namespace YYYCZ {
 		// Global Operate
 		bool eraseNumberFromPlace(save_t number, index_t index);
 		bool putNumberIntoForm(save_t number, index_t index);
+		void removeNumberFromForm(index_t index);
+		void syncHistory(SudokuHistory::version_t from);
+		bool checkCandidates() const; // the candidates are the same as a fresh init of the form
 		index_t findMinimumChoicesPlace() const;
+		int findHiddenSingle(save_t& number, index_t& place, index_t* unitFound = nullptr) const;
+		bool solveWithCache(bool useCache, bool* fromCache = nullptr, index_t* restarts = nullptr);
+		bool solveBySat(const std::vector<save_t>& form, const SudokuGeometry& geometry, bool useCache, SolveResult& result);
+		bool solveByAnnealing(const SolveOptions& options, SolveResult& result);
+		char selectBackend(const std::vector<save_t>& form, const std::shared_ptr<const SudokuGeometry>& blocks, const SudokuSelector* selector, bool& learn);
+		SudokuSelector::Features featuresOfBoard(double nodes) const;
+		bool isOverLimits();
+		bool searchWithRestarts(index_t& restarts);
+		static index_t luby(index_t i);
 		bool flashBack();
 		void save();
+		bool fillSingles();
+		void choicesOf(index_t index, std::vector<save_t>& choices) const;
+
+		// Policies of search, chosen once for a solving so no virtual call in the search
+		struct CellMinimumChoices {
+			static index_t select(const FastSudoku& sudoku, index_t minIndex);
+		};
+		struct CellDegree {
+			static index_t select(const FastSudoku& sudoku, index_t minIndex);
+		};
+		struct ValueSetOrder {
+			static void order(FastSudoku& sudoku, index_t index, std::vector<save_t>& choices);
+		};
+		struct ValueLeastConstraining {
+			static void order(FastSudoku& sudoku, index_t index, std::vector<save_t>& choices);
+		};
+		struct ValueFrequency {
+			static void order(FastSudoku& sudoku, index_t index, std::vector<save_t>& choices);
+		};
+
+		// Sets of constraints, chosen once for a solving so the classic sudoku pays nothing for the variants
+		struct ConstraintsClassic {
+			static bool afterPut(FastSudoku&, save_t, index_t) { return true; }
+			static int settle(FastSudoku&) { return 0; }
+		};
+		struct ConstraintsPeers {
+			static bool afterPut(FastSudoku& sudoku, save_t number, index_t index);
+			static int settle(FastSudoku&) { return 0; }
+		};
+		struct ConstraintsKiller {
+			static bool afterPut(FastSudoku& sudoku, save_t number, index_t index);
+			static int settle(FastSudoku& sudoku);
+		};
+		template<typename Constraints>
+		bool solveWith();
+		template<typename CellPolicy, typename ValuePolicy, typename Constraints>
+		bool search();
+
+		// Learning Operate
+		static void mergeLevels(levels_t& into, const levels_t& from);
+		index_t literalKey(index_t place, save_t number) const;
+		bool hasCandidate(index_t place, save_t number) const;
+		index_t unitPlace(index_t unit, save_t i) const;
+		void explainErased(index_t place, save_t number, index_t level, levels_t& conflict) const;
+		void explainEmptyPlace(index_t place, index_t level, levels_t& conflict) const;
+		void explainUnit(index_t unit, save_t number, index_t except, index_t level, levels_t& conflict) const;
+		bool assignLearning(save_t number, index_t place, levels_t deps, index_t level, levels_t& conflict);
+		bool propagateNogoods(index_t place, save_t number, index_t level, levels_t& conflict);
+		void learnNogood(const levels_t& conflict);
+		bool searchLearning(index_t level, levels_t& conflict);
+
+		// Variant Operate
+		bool eraseCandidate(save_t number, index_t index);
+		bool eraseVariantPeers(save_t number, index_t index);
+		int propagateCage(index_t cage);
+		bool initVariant();
 
 		// Core Operate
 	protected:
-		void init(const save_t* form, const index_t formDim);
+		void init(const save_t* form, const std::shared_ptr<const SudokuGeometry>& geometry);
 		void init(const std::vector<save_t>& form);
 		bool solve();
+		static void printGrid(std::ostream& out, const SudokuGeometry& geometry, const std::function<void(index_t)>& printCell);
 
 	public:
 		// Function For Solve
@@ -104,23 +403,47 @@ namespace YYYCZ {
 		FastSudoku& reset(bool clearSettings = true);
 		FastSudoku& printForm(const index_t* selected = nullptr);
 		FastSudoku& printForm(const save_t row, const save_t column);
+		FastSudoku& printForm(std::ostream& out, const index_t* selected = nullptr);
+		FastSudoku& printForm(std::ostream& out, const save_t row, const save_t column);
+		static void printForm(std::ostream& out, const std::vector<save_t>& form, const BoardView* origin = nullptr); // the numbers of origin are green, and the blocks are of origin
 		FastSudoku& replay(bool stepPlay = true);
 		FastSudoku& setMarkChange(bool flag);
 		FastSudoku& solve(const std::vector<save_t>& form);
+		SolveResult solve(const std::vector<save_t>& form, const SolveOptions& options); // the state of search is dropped after it
+		FastSudoku& setSolutionCache(SolutionCache* cache);
+		FastSudoku& setGeometry(std::shared_ptr<const SudokuGeometry> geometry); // the layout of the forms of its size, null for the standard boxes
+		FastSudoku& setBackendSelector(std::shared_ptr<const SudokuSelector> selector); // the model choosing the backend, null for the rules of size
 
 		// Function For Play
 		FastSudoku& load(const std::vector<save_t>& form);
 		FastSudoku& setShowAfterFill(bool flag);
 		std::pair<save_t, std::pair<save_t, save_t>> tip() const;
 		std::unordered_set<save_t> getLegalNumbersAt(save_t row, save_t column) const;
+		mask_t getLegalMaskAt(save_t row, save_t column) const;
+		bool isOriginal(index_t index) const;
+		BoardView getView() const;
 		bool checkInit() const;
 		bool tryFill(save_t number, save_t row, save_t column);
 		bool undo();
+		bool redo();
 		FastSudoku& erase(save_t row, save_t column);
 		FastSudoku& restart();
+		FastSudoku& setCheckpoint(const std::string& name);
+		bool checkout(const std::string& name);
+		const SudokuHistory& getHistory() const;
 		bool isFinish() const;
 		bool automaticSolve();
 
+		// Function For Enumerate
+		EnumerateResult enumerate(const std::vector<save_t>& form, const SolutionSink& sink); // all the solutions, no limit
+		EnumerateResult enumerate(const std::vector<save_t>& form, const SolutionSink& sink, const EnumerateOptions& options);
+
+		// Function For Estimate
+		EstimateResult estimate(const std::vector<save_t>& form); // 64 probes
+		EstimateResult estimate(const std::vector<save_t>& form, const EstimateOptions& options);
+		SudokuSelector::Features measure(const std::vector<save_t>& form, index_t probes = 0,
+			const std::shared_ptr<const SudokuGeometry>& geometry = nullptr); // the features for the selector
+
 		// Function For Generate
 		bool generate(index_t numberCount = 20, save_t dim = 3, int maxGenerateTimes = 10);
 
@@ -138,6 +461,7 @@ namespace YYYCZ {
 		index_t getFormDimension() const;
 		index_t getFormLength() const;
 		index_t getFormSize() const;
+		const SudokuGeometry* getGeometry() const; // null if not init
 	};
 }
 
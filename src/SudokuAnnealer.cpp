@@ -0,0 +1,286 @@
+﻿// Code By YYYCZ
+
+#include "SudokuAnnealer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace YYYCZ {
+	/// <summary>
+	/// judge if the numbers of two places can be swapped, the number given in the row or column of a place is not moved to it
+	/// </summary>
+	/// <param name="a">a place</param>
+	/// <param name="b">another place</param>
+	/// <returns>if can swap</returns>
+	inline bool SudokuAnnealer::canSwap(index_t a, index_t b) const
+	{
+		if (allowed.empty()) return true;
+		return ((allowed[a] >> form[b]) & 1) && ((allowed[b] >> form[a]) & 1);
+	}
+
+	/// <summary>
+	/// swap the numbers of two places in one block, and count the cost of the rows and columns changed
+	/// </summary>
+	/// <param name="a">a place</param>
+	/// <param name="b">another place</param>
+	/// <returns>the change of cost</returns>
+	int SudokuAnnealer::swapPlaces(index_t a, index_t b)
+	{
+		const save_t numberA = form[a], numberB = form[b];
+		const index_t stride = formLength + 1;
+		const index_t rowA = a / formLength, columnA = a % formLength;
+		const index_t rowB = b / formLength, columnB = b % formLength;
+
+		// a number taken out is missing if it is the last one, a number put in is not missing if it is the first one
+		auto take = [](index_t& count) { return --count == 0 ? 1 : 0; };
+		auto put = [](index_t& count) { return count++ == 0 ? -1 : 0; };
+		int delta = 0;
+		if (rowA != rowB) {
+			delta += take(rowCount[rowA * stride + numberA]) + put(rowCount[rowA * stride + numberB]);
+			delta += take(rowCount[rowB * stride + numberB]) + put(rowCount[rowB * stride + numberA]);
+		}
+		if (columnA != columnB) {
+			delta += take(columnCount[columnA * stride + numberA]) + put(columnCount[columnA * stride + numberB]);
+			delta += take(columnCount[columnB * stride + numberB]) + put(columnCount[columnB * stride + numberA]);
+		}
+
+		form[a] = numberB;
+		form[b] = numberA;
+		cost = (index_t)((int)cost + delta);
+		return delta;
+	}
+
+	/// <summary>
+	/// pick two blanks of a random block
+	/// </summary>
+	/// <param name="a">a place</param>
+	/// <param name="b">another place</param>
+	/// <returns>if they can be swapped</returns>
+	inline bool SudokuAnnealer::pickMove(index_t& a, index_t& b)
+	{
+		const auto& places = blanks[random() % blanks.size()];
+		const index_t i = random() % places.size();
+		index_t j = random() % (places.size() - 1);
+		if (j >= i) ++j;
+		a = places[i];
+		b = places[j];
+		return canSwap(a, b);
+	}
+
+	/// <summary>
+	/// fill the blanks of a block with the numbers missing in it,
+	/// the places with fewer choices first, and the numbers given in their rows and columns are avoided
+	/// </summary>
+	/// <param name="block">the block</param>
+	/// <param name="places">the blank places of block</param>
+	void SudokuAnnealer::fillBlock(index_t block, const std::vector<index_t>& places)
+	{
+		std::vector<char> used(formLength + 1, 0);
+		for (index_t i = 0; i < formLength; ++i) {
+			const index_t place = geometry->placeOf(block, i);
+			if (given[place]) used[form[place]] = 1;
+		}
+		std::vector<save_t> missing;
+		for (save_t number = 1; (index_t)number <= formLength; ++number) {
+			if (!used[number]) missing.push_back(number);
+		}
+		std::shuffle(missing.begin(), missing.end(), random);
+
+		std::vector<index_t> order = places;
+		if (!allowed.empty()) {
+			std::stable_sort(order.begin(), order.end(), [this](index_t a, index_t b) {
+				return FastSudoku::BoardView::countOf(allowed[a]) < FastSudoku::BoardView::countOf(allowed[b]);
+			});
+		}
+		std::vector<char> taken(missing.size(), 0);
+		for (index_t place : order) {
+			for (size_t k = 0; k < missing.size(); ++k) {
+				if (!taken[k] && (allowed.empty() || ((allowed[place] >> missing[k]) & 1))) {
+					form[place] = missing[k];
+					taken[k] = 1;
+					break;
+				}
+			}
+		}
+
+		// the rest numbers in the rest places
+		size_t k = 0;
+		for (index_t place : order) {
+			if (form[place]) continue;
+			while (taken[k]) ++k;
+			form[place] = missing[k];
+			taken[k] = 1;
+		}
+	}
+
+	/// <summary>
+	/// load the sudoku and fill every block as a permutation
+	/// </summary>
+	/// <param name="view">the board, the givens are kept and the candidates avoid the numbers given</param>
+	/// <param name="seed">the seed of random moves</param>
+	/// <returns>false if the givens make no solution</returns>
+	bool SudokuAnnealer::load(const FastSudoku::BoardView& view, unsigned int seed)
+	{
+		geometry = view.geometry;
+		formLength = view.length;
+		formSize = view.size;
+		random.seed(seed);
+		moves = 0;
+		cost = 0;
+		blanks.clear();
+		if (!geometry) return false;
+
+		const index_t stride = formLength + 1;
+		form.assign(formSize, 0);
+		given.assign(formSize, 0);
+		rowCount.assign(formLength * stride, 0);
+		columnCount.assign(formLength * stride, 0);
+		allowed.clear();
+		if (formLength < 64) allowed.assign(view.candidates, view.candidates + formSize);
+
+		// the givens can't be repeated, and the blanks must have a choice
+		std::vector<index_t> blockCount(formLength * stride, 0);
+		for (index_t place = 0; place < formSize; ++place) {
+			const index_t row = place / formLength, column = place % formLength;
+			const index_t block = geometry->blockOf(place);
+			if (!view.isGiven(place)) {
+				if (!allowed.empty() && allowed[place] == 0) return false;
+				continue;
+			}
+			const save_t number = view.value(place);
+			form[place] = number;
+			given[place] = 1;
+			if (++blockCount[block * stride + number] > 1) return false;
+			if (rowCount[row * stride + number]++ || columnCount[column * stride + number]++) return false;
+		}
+
+		// every block is a permutation
+		for (index_t block = 0; block < formLength; ++block) {
+			std::vector<index_t> places;
+			for (index_t i = 0; i < formLength; ++i) {
+				const index_t place = geometry->placeOf(block, i);
+				if (!given[place]) places.push_back(place);
+			}
+			fillBlock(block, places);
+			for (index_t place : places) {
+				++rowCount[place / formLength * stride + form[place]];
+				++columnCount[place % formLength * stride + form[place]];
+			}
+			if (places.size() >= 2) blanks.push_back(std::move(places));
+		}
+		for (index_t i = 0; i < formLength; ++i) {
+			for (save_t number = 1; (index_t)number <= formLength; ++number) {
+				cost += (rowCount[i * stride + number] == 0) + (columnCount[i * stride + number] == 0);
+			}
+		}
+
+		// the first temperature is the deviation of the costs of random moves
+		double sum = 0, squareSum = 0;
+		index_t samples = 0;
+		for (index_t i = 0; i < 200 && !blanks.empty(); ++i) {
+			index_t a, b;
+			if (!pickMove(a, b)) continue;
+			const int delta = swapPlaces(a, b);
+			swapPlaces(a, b);
+			sum += delta;
+			squareSum += (double)delta * delta;
+			++samples;
+		}
+		startTemperature = samples > 1 ? std::sqrt(std::max(0.0, (squareSum - sum * sum / samples) / (samples - 1))) : 1;
+		if (startTemperature <= 0) startTemperature = 1;
+		temperature = startTemperature;
+		return true;
+	}
+
+	/// <summary>
+	/// anneal until the cost is small enough. the temperature cools every chain of moves,
+	/// and it is heated again when the cost is not better for a long time
+	/// </summary>
+	/// <param name="targetCost">the cost to reach</param>
+	/// <param name="stop">called every move, true to stop</param>
+	/// <returns>false if stopped, or no move can be made</returns>
+	bool SudokuAnnealer::run(index_t targetCost, const StopChecker& stop)
+	{
+		if (cost <= targetCost) return true;
+		if (blanks.empty()) return false;
+
+		constexpr double cooling = 0.99;
+		constexpr index_t reheatChains = 1000;
+		index_t chainLength = 0; // 10 moves a blank
+		for (auto& places : blanks) chainLength += 10 * (index_t)places.size();
+		std::uniform_real_distribution<double> uniform(0, 1);
+
+		index_t best = cost, staleChains = 0;
+		while (cost > targetCost) {
+			for (index_t i = 0; i < chainLength && cost > targetCost; ++i) {
+				++moves;
+				if (stop && stop(moves)) return false;
+				index_t a, b;
+				if (!pickMove(a, b)) continue;
+				const int delta = swapPlaces(a, b);
+				if (delta > 0 && uniform(random) >= std::exp(-delta / temperature)) swapPlaces(a, b);
+			}
+
+			temperature *= cooling;
+			if (cost < best) {
+				best = cost;
+				staleChains = 0;
+			}
+			else if (++staleChains >= reheatChains) {
+				temperature = startTemperature;
+				best = cost;
+				staleChains = 0;
+			}
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// get the count of numbers missing in the rows and columns
+	/// </summary>
+	/// <returns>cost</returns>
+	SudokuAnnealer::index_t SudokuAnnealer::getCost() const
+	{
+		return cost;
+	}
+
+	/// <summary>
+	/// get the times of move
+	/// </summary>
+	/// <returns>times</returns>
+	SudokuAnnealer::index_t SudokuAnnealer::getMoves() const
+	{
+		return moves;
+	}
+
+	/// <summary>
+	/// get the numbers now, a solution if the cost is 0
+	/// </summary>
+	/// <returns>form</returns>
+	const std::vector<SudokuAnnealer::save_t>& SudokuAnnealer::getForm() const
+	{
+		return form;
+	}
+
+	/// <summary>
+	/// get the givens and the numbers of the rows and columns without conflict,
+	/// the other places are blank for the exact search
+	/// </summary>
+	/// <returns>form</returns>
+	std::vector<SudokuAnnealer::save_t> SudokuAnnealer::getPartial() const
+	{
+		const index_t stride = formLength + 1;
+		std::vector<char> badRow(formLength, 0), badColumn(formLength, 0);
+		for (index_t i = 0; i < formLength; ++i) {
+			for (save_t number = 1; (index_t)number <= formLength; ++number) {
+				if (rowCount[i * stride + number] == 0) badRow[i] = 1;
+				if (columnCount[i * stride + number] == 0) badColumn[i] = 1;
+			}
+		}
+
+		std::vector<save_t> partial = form;
+		for (index_t place = 0; place < formSize; ++place) {
+			if (!given[place] && (badRow[place / formLength] || badColumn[place % formLength])) partial[place] = 0;
+		}
+		return partial;
+	}
+}
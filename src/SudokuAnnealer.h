@@ -0,0 +1,57 @@
+﻿// Code By YYYCZ
+
+#ifndef __YYYCZ_SUDOKU_ANNEALER_H__
+#define __YYYCZ_SUDOKU_ANNEALER_H__
+
+#include "FastSudoku.h"
+#include <functional>
+#include <random>
+#include <vector>
+
+namespace YYYCZ {
+	// the local search for the huge sudokus (49x49 and larger) by simulated annealing.
+	// every block (box or jigsaw region) is always a permutation of the numbers with the givens kept,
+	// so only the rows and columns have conflicts, and a move swaps two blanks of a block.
+	// the cost is the count of numbers missing in the rows and columns,
+	// a move changes 2 rows and 2 columns at most, so only they are counted again.
+	// NOT THREAD SAFE
+	class SudokuAnnealer {
+	public:
+		using save_t = FastSudoku::save_t;
+		using index_t = FastSudoku::index_t;
+		using mask_t = FastSudoku::mask_t;
+		using StopChecker = std::function<bool(index_t moves)>; // called every move, true to stop
+
+	private:
+		const SudokuGeometry* geometry = nullptr; // the blocks of the form
+		index_t formLength = 0; // the length of the form
+		index_t formSize = 0; // the size of the form
+		std::vector<save_t> form; // the numbers now
+		std::vector<char> given; // if the place is given
+		std::vector<mask_t> allowed; // the numbers not given in the row, column and block, empty if length >= 64
+		std::vector<std::vector<index_t>> blanks; // the blank places of blocks, only the blocks with two at least
+		std::vector<index_t> rowCount; // count of number in row, row * (length + 1) + number
+		std::vector<index_t> columnCount; // count of number in column, column * (length + 1) + number
+		index_t cost = 0; // the numbers missing in the rows and columns
+		index_t moves = 0; // the times of move
+		double temperature = 0; // the temperature now
+		double startTemperature = 0; // the temperature to begin and reheat
+		std::mt19937 random; // the random moves
+
+		bool canSwap(index_t a, index_t b) const;
+		int swapPlaces(index_t a, index_t b);
+		bool pickMove(index_t& a, index_t& b);
+		void fillBlock(index_t block, const std::vector<index_t>& places);
+
+	public:
+		bool load(const FastSudoku::BoardView& view, unsigned int seed = 0); // false if the givens make no solution
+		bool run(index_t targetCost, const StopChecker& stop = StopChecker()); // until the cost is at most target, false if stopped
+
+		index_t getCost() const;
+		index_t getMoves() const;
+		const std::vector<save_t>& getForm() const;
+		std::vector<save_t> getPartial() const; // the givens and the rows and columns without conflict, for the exact search
+	};
+}
+
+#endif
@@ -0,0 +1,212 @@
+﻿// Code By YYYCZ
+
+#include "SudokuCache.h"
+#include <cstdint>
+
+namespace YYYCZ {
+	/// <summary>
+	/// create the cache
+	/// </summary>
+	/// <param name="capacity">max count of solutions in memory</param>
+	/// <param name="shardCount">count of shards</param>
+	/// <param name="logPath">path of the log file, empty if not use</param>
+	SolutionCache::SolutionCache(index_t capacity, index_t shardCount, const std::string& logPath)
+		: shards(shardCount ? shardCount : 1)
+	{
+		shardCapacity = (capacity + (index_t)shards.size() - 1) / (index_t)shards.size();
+		if (shardCapacity == 0) shardCapacity = 1;
+
+		if (!logPath.empty()) {
+			loadLog(logPath);
+			logFile = fopen(logPath.c_str(), "ab");
+		}
+	}
+
+	/// <summary>
+	/// close the log file
+	/// </summary>
+	SolutionCache::~SolutionCache()
+	{
+		if (logFile) fclose(logFile);
+	}
+
+	/// <summary>
+	/// get the shard of the hash
+	/// </summary>
+	/// <param name="hash">hash</param>
+	/// <returns>shard</returns>
+	inline SolutionCache::Shard& SolutionCache::shardOf(const SudokuCanonical::Hash& hash)
+	{
+		return shards[hash.high % shards.size()];
+	}
+
+	/// <summary>
+	/// put the entry into the LRU
+	/// </summary>
+	/// <param name="entry">entry</param>
+	void SolutionCache::put(Entry&& entry)
+	{
+		Shard& shard = shardOf(entry.hash);
+		std::lock_guard<std::mutex> guard(shard.lock);
+
+		auto itr = shard.index.find(entry.hash);
+		if (itr != shard.index.end()) {
+			*itr->second = std::move(entry);
+			shard.items.splice(shard.items.begin(), shard.items, itr->second);
+			return;
+		}
+
+		shard.items.push_front(std::move(entry));
+		shard.index[shard.items.front().hash] = shard.items.begin();
+		if (shard.items.size() > shardCapacity) {
+			shard.index.erase(shard.items.back().hash);
+			shard.items.pop_back();
+		}
+	}
+
+	/// <summary>
+	/// load the entries from the log file.
+	/// the record is: form size, solution size, then the cells of them (all uint32)
+	/// </summary>
+	/// <param name="path">path of log file</param>
+	void SolutionCache::loadLog(const std::string& path)
+	{
+		FILE* file = fopen(path.c_str(), "rb");
+		if (!file) return;
+
+		uint32_t sizes[2];
+		while (fread(sizes, sizeof(uint32_t), 2, file) == 2) {
+			// broken record, maybe the program stopped when writing
+			if (sizes[0] == 0 || (sizes[1] != 0 && sizes[1] != sizes[0])) break;
+
+			std::vector<uint32_t> cells(sizes[0] + sizes[1]);
+			if (fread(cells.data(), sizeof(uint32_t), cells.size(), file) != cells.size()) break;
+
+			Entry entry;
+			entry.canonical.assign(cells.begin(), cells.begin() + sizes[0]);
+			entry.solution.assign(cells.begin() + sizes[0], cells.end());
+			entry.hash = SudokuCanonical::hashForm(entry.canonical);
+			put(std::move(entry));
+		}
+		fclose(file);
+	}
+
+	/// <summary>
+	/// append the entry to the log file
+	/// </summary>
+	/// <param name="entry">entry</param>
+	void SolutionCache::appendLog(const Entry& entry)
+	{
+		if (!logFile) return;
+
+		std::vector<uint32_t> record;
+		record.reserve(2 + entry.canonical.size() + entry.solution.size());
+		record.push_back((uint32_t)entry.canonical.size());
+		record.push_back((uint32_t)entry.solution.size());
+		record.insert(record.end(), entry.canonical.begin(), entry.canonical.end());
+		record.insert(record.end(), entry.solution.begin(), entry.solution.end());
+
+		std::lock_guard<std::mutex> guard(logLock);
+		fwrite(record.data(), sizeof(uint32_t), record.size(), logFile);
+		fflush(logFile);
+	}
+
+	/// <summary>
+	/// get the key of one sudoku
+	/// </summary>
+	/// <param name="form">sudoku form</param>
+	/// <returns>key</returns>
+	SolutionCache::Key SolutionCache::makeKey(const std::vector<save_t>& form) const
+	{
+		thread_local SudokuCanonical canonical;
+		canonical.canonicalize(form);
+		return Key{ canonical.getHash(), canonical.getResult(), canonical.getTransform() };
+	}
+
+	/// <summary>
+	/// find the solution of the sudoku
+	/// </summary>
+	/// <param name="key">key of the sudoku</param>
+	/// <param name="solution">the solution of the sudoku, empty if no solution</param>
+	/// <returns>if find</returns>
+	bool SolutionCache::find(const Key& key, std::vector<save_t>& solution)
+	{
+		{
+			Shard& shard = shardOf(key.hash);
+			std::lock_guard<std::mutex> guard(shard.lock);
+
+			auto itr = shard.index.find(key.hash);
+			if (itr != shard.index.end() && itr->second->canonical == key.canonical) {
+				shard.items.splice(shard.items.begin(), shard.items, itr->second);
+				solution = itr->second->solution;
+			}
+			else {
+				++missTimes;
+				return false;
+			}
+		}
+
+		// map back to the sudoku
+		if (!solution.empty()) solution = key.transform.revert(solution);
+		++hitTimes;
+		return true;
+	}
+
+	/// <summary>
+	/// store the solution of the sudoku
+	/// </summary>
+	/// <param name="key">key of the sudoku</param>
+	/// <param name="solution">the solution of the sudoku, empty if no solution</param>
+	void SolutionCache::store(const Key& key, const std::vector<save_t>& solution)
+	{
+		Entry entry{ key.hash, key.canonical, solution.empty() ? solution : key.transform.apply(solution) };
+		appendLog(entry);
+		put(std::move(entry));
+	}
+
+	/// <summary>
+	/// get the times of hit
+	/// </summary>
+	/// <returns>hit times</returns>
+	unsigned long long SolutionCache::getHitTimes() const
+	{
+		return hitTimes;
+	}
+
+	/// <summary>
+	/// get the times of miss
+	/// </summary>
+	/// <returns>miss times</returns>
+	unsigned long long SolutionCache::getMissTimes() const
+	{
+		return missTimes;
+	}
+
+	/// <summary>
+	/// get the count of solutions in memory
+	/// </summary>
+	/// <returns>count</returns>
+	size_t SolutionCache::size()
+	{
+		size_t res = 0;
+		for (auto& shard : shards) {
+			std::lock_guard<std::mutex> guard(shard.lock);
+			res += shard.items.size();
+		}
+		return res;
+	}
+
+	/// <summary>
+	/// clear the solutions in memory (the log file is kept)
+	/// </summary>
+	/// <returns>SolutionCache</returns>
+	SolutionCache& SolutionCache::clear()
+	{
+		for (auto& shard : shards) {
+			std::lock_guard<std::mutex> guard(shard.lock);
+			shard.items.clear();
+			shard.index.clear();
+		}
+		return *this;
+	}
+}
@@ -0,0 +1,77 @@
+﻿// Code By YYYCZ
+
+#ifndef __YYYCZ_SUDOKU_CACHE_H__
+#define __YYYCZ_SUDOKU_CACHE_H__
+
+#include "SudokuCanonical.h"
+#include <list>
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <cstdio>
+#include <unordered_map>
+
+namespace YYYCZ {
+	// a cache of the solutions keyed by the canonical form,
+	// so the isomorphic sudokus share one solution.
+	// in memory is a sharded LRU, and it can append to a log file
+	// which is reloaded when the cache is created.
+	// THREAD SAFE
+	class SolutionCache {
+	public:
+		using save_t = FastSudoku::save_t;
+		using index_t = FastSudoku::index_t;
+
+		// the key of one sudoku
+		struct Key {
+			SudokuCanonical::Hash hash; // hash of canonical form
+			std::vector<save_t> canonical; // canonical form
+			SudokuCanonical::Transform transform; // transform from the sudoku to canonical form
+		};
+
+	private:
+		// one item of the cache
+		struct Entry {
+			SudokuCanonical::Hash hash;
+			std::vector<save_t> canonical; // canonical form
+			std::vector<save_t> solution; // solution of canonical form, empty if no solution
+		};
+
+		// one shard of the LRU
+		struct Shard {
+			std::mutex lock;
+			std::list<Entry> items; // most recently used at front
+			std::unordered_map<SudokuCanonical::Hash, std::list<Entry>::iterator> index;
+		};
+
+		index_t shardCapacity = 0; // capacity of one shard
+		std::vector<Shard> shards; // shards of LRU
+		std::atomic<unsigned long long> hitTimes{ 0 }; // times of hit
+		std::atomic<unsigned long long> missTimes{ 0 }; // times of miss
+
+		std::mutex logLock; // lock of the log file
+		FILE* logFile = nullptr; // the log file, null if not use
+
+		Shard& shardOf(const SudokuCanonical::Hash& hash);
+		void put(Entry&& entry);
+		void loadLog(const std::string& path);
+		void appendLog(const Entry& entry);
+
+	public:
+		SolutionCache(index_t capacity = 1 << 16, index_t shardCount = 16, const std::string& logPath = "");
+		SolutionCache(const SolutionCache&) = delete;
+		SolutionCache& operator=(const SolutionCache&) = delete;
+		~SolutionCache();
+
+		Key makeKey(const std::vector<save_t>& form) const; // get the key of one sudoku
+		bool find(const Key& key, std::vector<save_t>& solution); // find the solution (mapped back to the sudoku)
+		void store(const Key& key, const std::vector<save_t>& solution); // store the solution of the sudoku
+
+		unsigned long long getHitTimes() const;
+		unsigned long long getMissTimes() const;
+		size_t size();
+		SolutionCache& clear();
+	};
+}
+
+#endif
@@ -0,0 +1,415 @@
+﻿// Code By YYYCZ
+
+#include "SudokuCanonical.h"
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <cstring>
+#include <cmath>
+
+namespace YYYCZ {
+	/// <summary>
+	/// mix the bits of one 64 bits number (splitmix64 finalizer)
+	/// </summary>
+	/// <param name="x">number</param>
+	/// <returns>mixed number</returns>
+	static inline uint64_t mixBits(uint64_t x)
+	{
+		x ^= x >> 30;
+		x *= 0xBF58476D1CE4E5B9ull;
+		x ^= x >> 27;
+		x *= 0x94D049BB133111EBull;
+		x ^= x >> 31;
+		return x;
+	}
+
+	/// <summary>
+	/// transform the original form to the canonical form
+	/// </summary>
+	/// <param name="form">original form</param>
+	/// <returns>canonical form</returns>
+	std::vector<SudokuCanonical::save_t> SudokuCanonical::Transform::apply(const std::vector<save_t>& form) const
+	{
+		const index_t length = (index_t)rowOrder.size();
+		if (length == 0 || form.size() != length * length) return form;
+
+		std::vector<save_t> res(form.size(), 0);
+		for (index_t i = 0; i < length; ++i) {
+			for (index_t j = 0; j < length; ++j) {
+				const index_t r = rowOrder[i], c = columnOrder[j];
+				save_t v = transpose ? form[c * length + r] : form[r * length + c];
+				res[i * length + j] = (0 < v && v < (save_t)relabel.size()) ? relabel[v] : 0;
+			}
+		}
+		return res;
+	}
+
+	/// <summary>
+	/// transform the canonical form back to the original form
+	/// </summary>
+	/// <param name="form">canonical form (such as the solution of canonical form)</param>
+	/// <returns>original form</returns>
+	std::vector<SudokuCanonical::save_t> SudokuCanonical::Transform::revert(const std::vector<save_t>& form) const
+	{
+		const index_t length = (index_t)rowOrder.size();
+		if (length == 0 || form.size() != length * length) return form;
+
+		std::vector<save_t> inverse(relabel.size(), 0);
+		for (save_t d = 1; d < (save_t)relabel.size(); ++d) {
+			inverse[relabel[d]] = d;
+		}
+
+		std::vector<save_t> res(form.size(), 0);
+		for (index_t i = 0; i < length; ++i) {
+			for (index_t j = 0; j < length; ++j) {
+				const index_t r = rowOrder[i], c = columnOrder[j];
+				save_t v = form[i * length + j];
+				(transpose ? res[c * length + r] : res[r * length + c]) =
+					(0 < v && v < (save_t)inverse.size()) ? inverse[v] : 0;
+			}
+		}
+		return res;
+	}
+
+	/// <summary>
+	/// get all the column permutations which keep the stacks
+	/// </summary>
+	/// <param name="dim">dimension (2 or 3)</param>
+	/// <returns>permutations</returns>
+	const std::vector<std::vector<uint8_t>>& SudokuCanonical::columnPerms(index_t dim)
+	{
+		static const auto tables = []() {
+			std::vector<std::vector<std::vector<uint8_t>>> res(4);
+			for (uint8_t d = 2; d <= 3; ++d) {
+				std::vector<std::vector<uint8_t>> small;
+				std::vector<uint8_t> p(d);
+				for (uint8_t k = 0; k < d; ++k) p[k] = k;
+				do small.push_back(p); while (std::next_permutation(p.begin(), p.end()));
+
+				// stacks order, then the order in every stack
+				std::vector<std::vector<uint8_t>> all;
+				for (auto& stacks : small) {
+					std::vector<size_t> inner(d, 0);
+					while (true) {
+						std::vector<uint8_t> perm;
+						for (uint8_t s = 0; s < d; ++s) {
+							for (uint8_t k = 0; k < d; ++k) {
+								perm.push_back(stacks[s] * d + small[inner[s]][k]);
+							}
+						}
+						all.push_back(perm);
+
+						uint8_t s = 0;
+						while (s < d && ++inner[s] == small.size()) inner[s++] = 0;
+						if (s == d) break;
+					}
+				}
+				res[d] = std::move(all);
+			}
+			return res;
+		}();
+		return tables[dim];
+	}
+
+	/// <summary>
+	/// only relabel the digits in order of appearance
+	/// </summary>
+	/// <param name="form">sanitized form</param>
+	void SudokuCanonical::relabelOnly(const std::vector<save_t>& form)
+	{
+		transform.transpose = false;
+		transform.rowOrder.resize(formLength);
+		transform.columnOrder.resize(formLength);
+		std::iota(transform.rowOrder.begin(), transform.rowOrder.end(), 0);
+		std::iota(transform.columnOrder.begin(), transform.columnOrder.end(), 0);
+		transform.relabel.assign(formLength + 1, 0);
+
+		save_t next = 1;
+		for (auto v : form) {
+			if (v != 0 && transform.relabel[v] == 0) {
+				transform.relabel[v] = next++;
+			}
+		}
+		for (save_t d = 1; d <= (save_t)formLength; ++d) {
+			if (transform.relabel[d] == 0) transform.relabel[d] = next++;
+		}
+		result = transform.apply(form);
+	}
+
+	/// <summary>
+	/// search the minimal form row by row, only keep the states
+	/// which produce the minimal rows so far
+	/// </summary>
+	/// <param name="form">sanitized form</param>
+	void SudokuCanonical::searchMinimal(const std::vector<save_t>& form)
+	{
+		const index_t length = formLength, dim = formDim;
+		if (length > SearchLength || dim * dim != length) {
+			relabelOnly(form);
+			return;
+		}
+		const save_t blank = (save_t)length + 1;
+		const auto& perms = columnPerms(dim);
+
+		// the form and its transpose
+		sources[0] = form;
+		sources[1].resize(form.size());
+		for (index_t i = 0; i < length; ++i) {
+			for (index_t j = 0; j < length; ++j) {
+				sources[1][j * length + i] = form[i * length + j];
+			}
+		}
+
+		// try to put row r of the state as the level-th row
+		save_t row[SearchLength];
+		auto tryRow = [&](const State& s, index_t level, uint8_t r) {
+			const save_t* src = &sources[s.transpose][r * length];
+			const uint8_t* perm = perms[s.columnPerm].data();
+			uint8_t labels[SearchLength + 1];
+			std::memcpy(labels, s.labels, sizeof(labels));
+			uint8_t next = s.next;
+
+			bool less = nextStates.empty();
+			for (index_t j = 0; j < length; ++j) {
+				save_t v = src[perm[j]];
+				save_t key = blank;
+				if (v != 0) {
+					if (labels[v] == 0) labels[v] = next++;
+					key = labels[v];
+				}
+				row[j] = key;
+				if (!less) {
+					if (key < best[j]) less = true;
+					else if (key > best[j]) return;
+				}
+			}
+			if (less) {
+				nextStates.clear();
+				best.assign(row, row + length);
+			}
+
+			nextStates.push_back(s);
+			State& ns = nextStates.back();
+			ns.rows[level] = r;
+			ns.next = next;
+			std::memcpy(ns.labels, labels, sizeof(labels));
+
+			// same transpose, column permutation, used rows and labels
+			// means same future, so they are duplicate
+			uint64_t used = 0;
+			for (index_t k = 0; k <= level; ++k) used |= 1ull << ns.rows[k];
+			ns.key = ns.transpose | ((uint64_t)ns.columnPerm << 1) | (used << 12);
+			for (index_t d = 1; d <= length; ++d) {
+				ns.key |= (uint64_t)labels[d] << (21 + 4 * (d - 1));
+			}
+		};
+
+		result.clear();
+		states.clear();
+		nextStates.clear();
+
+		// the first row only depends on where the blanks are,
+		// so find the rows with the best blank pattern before trying the permutations
+		auto patternOf = [&](uint32_t mask, const uint8_t* perm) {
+			uint32_t pattern = 0;
+			for (index_t j = 0; j < length; ++j) pattern = pattern << 1 | (mask >> perm[j] & 1);
+			return pattern;
+		};
+		auto bestPatternOf = [&](uint32_t mask) {
+			// the stacks not used are 0, so they are sorted to the end
+			std::array<index_t, 3> counts{};
+			for (index_t c = 0; c < length; ++c) counts[c / dim] += mask >> c & 1;
+			std::sort(counts.begin(), counts.end(), [](index_t a, index_t b) { return a > b; });
+			uint32_t pattern = 0;
+			for (index_t s = 0; s < dim; ++s) {
+				for (index_t k = 0; k < dim; ++k) pattern = pattern << 1 | (k < counts[s] ? 1u : 0u);
+			}
+			return pattern;
+		};
+
+		uint32_t masks[2][SearchLength] = {}, bestPattern = 0;
+		for (uint8_t t = 0; t < 2; ++t) {
+			for (index_t r = 0; r < length; ++r) {
+				for (index_t c = 0; c < length; ++c) {
+					if (sources[t][r * length + c] != 0) masks[t][r] |= 1u << c;
+				}
+				bestPattern = std::max(bestPattern, bestPatternOf(masks[t][r]));
+			}
+		}
+
+		// all blanks, nothing to do
+		if (bestPattern == 0) {
+			relabelOnly(form);
+			return;
+		}
+
+		if (cachedDim != dim) {
+			cachedDim = dim;
+			bestPerms.assign((size_t)1 << length, std::vector<uint16_t>());
+			bestPermsReady.assign((size_t)1 << length, false);
+		}
+		for (uint8_t t = 0; t < 2; ++t) {
+			for (uint8_t r = 0; r < length; ++r) {
+				const uint32_t mask = masks[t][r];
+				if (bestPatternOf(mask) != bestPattern) continue;
+				if (!bestPermsReady[mask]) {
+					for (uint16_t p = 0; p < perms.size(); ++p) {
+						if (patternOf(mask, perms[p].data()) == bestPattern) bestPerms[mask].push_back(p);
+					}
+					bestPermsReady[mask] = true;
+				}
+				for (auto p : bestPerms[mask]) {
+					State seed;
+					seed.transpose = t;
+					seed.columnPerm = p;
+					tryRow(seed, 0, r);
+				}
+			}
+		}
+
+		for (index_t level = 0; ; ) {
+			// remove the duplicate states
+			std::sort(nextStates.begin(), nextStates.end(),
+				[](const State& a, const State& b) { return a.key < b.key; });
+			nextStates.erase(std::unique(nextStates.begin(), nextStates.end(),
+				[](const State& a, const State& b) { return a.key == b.key; }), nextStates.end());
+				states.swap(nextStates);
+			nextStates.clear();
+			result.insert(result.end(), best.begin(), best.end());
+
+			// the best row of a new band is blank, so all the rest rows are blank
+			if (level % dim == 0 && *std::min_element(best.begin(), best.end()) == blank) {
+				State& s = states.front();
+				uint32_t used = 0;
+				for (index_t k = 0; k <= level; ++k) used |= 1u << s.rows[k];
+				for (uint8_t r = 0; r < length; ++r) {
+					if (!(used >> r & 1)) s.rows[++level] = r;
+				}
+				result.resize(form.size(), blank);
+				break;
+			}
+
+			if (++level == length) break;
+
+			// the next row must be in the same band, or begin a new band
+			for (auto& s : states) {
+				uint32_t used = 0;
+				for (index_t k = 0; k < level; ++k) used |= 1u << s.rows[k];
+
+				if (level % dim != 0) {
+					uint8_t band = s.rows[level - 1] / dim;
+					for (uint8_t r = band * dim; r < (band + 1) * dim; ++r) {
+						if (!(used >> r & 1)) tryRow(s, level, r);
+					}
+				}
+				else {
+					for (uint8_t r = 0; r < length; ++r) {
+						if (!(used >> (r / dim * dim) & 1)) tryRow(s, level, r);
+					}
+				}
+			}
+		}
+
+		// get the transform
+		const State& s = states.front();
+		transform.transpose = s.transpose != 0;
+		transform.rowOrder.assign(s.rows, s.rows + length);
+		transform.columnOrder.assign(perms[s.columnPerm].begin(), perms[s.columnPerm].end());
+		transform.relabel.assign(length + 1, 0);
+		save_t next = s.next;
+		for (index_t d = 1; d <= length; ++d) {
+			transform.relabel[d] = s.labels[d] ? s.labels[d] : next++;
+		}
+
+		// blanks are 0 in the result
+		for (auto& v : result) {
+			if (v == blank) v = 0;
+		}
+	}
+
+	/// <summary>
+	/// get the canonical form of the sudoku
+	/// </summary>
+	/// <param name="form">sudoku form</param>
+	/// <returns>SudokuCanonical</returns>
+	SudokuCanonical& SudokuCanonical::canonicalize(const std::vector<save_t>& form)
+	{
+		formLength = (index_t)std::lround(std::sqrt((double)form.size()));
+		formDim = (index_t)std::lround(std::sqrt((double)formLength));
+
+		// not a sudoku form
+		if (form.empty() || formLength * formLength != form.size()) {
+			formDim = formLength = 0;
+			result = form;
+			transform = Transform();
+			hash = hashForm(result);
+			return *this;
+		}
+
+		// illegal numbers are blanks
+		std::vector<save_t> sanitized(form);
+		for (auto& v : sanitized) {
+			if (v < 0 || v > (save_t)formLength) v = 0;
+		}
+
+		if (formDim * formDim == formLength && formDim >= 2 && formDim <= 3) {
+			searchMinimal(sanitized);
+		}
+		else {
+			relabelOnly(sanitized);
+		}
+		hash = hashForm(result);
+		return *this;
+	}
+
+	/// <summary>
+	/// get the canonical form
+	/// </summary>
+	/// <returns>canonical form</returns>
+	const std::vector<SudokuCanonical::save_t>& SudokuCanonical::getResult() const
+	{
+		return result;
+	}
+
+	/// <summary>
+	/// get the transform from original form to canonical form
+	/// </summary>
+	/// <returns>transform</returns>
+	const SudokuCanonical::Transform& SudokuCanonical::getTransform() const
+	{
+		return transform;
+	}
+
+	/// <summary>
+	/// get the hash of canonical form
+	/// </summary>
+	/// <returns>hash</returns>
+	SudokuCanonical::Hash SudokuCanonical::getHash() const
+	{
+		return hash;
+	}
+
+	/// <summary>
+	/// get the 128 bits hash of one form
+	/// </summary>
+	/// <param name="form">form</param>
+	/// <returns>hash</returns>
+	SudokuCanonical::Hash SudokuCanonical::hashForm(const std::vector<save_t>& form)
+	{
+		Hash h{ 0x243F6A8885A308D3ull ^ form.size(), 0x13198A2E03707344ull };
+		uint64_t word = 0;
+		index_t count = 0;
+		auto flush = [&]() {
+			h.high = mixBits(h.high ^ word);
+			h.low = mixBits(h.low + word * 0x9E3779B97F4A7C15ull);
+			word = 0;
+			count = 0;
+		};
+		for (auto v : form) {
+			word |= (uint64_t)(uint16_t)v << (16 * count);
+			if (++count == 4) flush();
+		}
+		if (count) flush();
+		return h;
+	}
+}
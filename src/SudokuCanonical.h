@@ -0,0 +1,93 @@
+﻿// Code By YYYCZ
+
+#ifndef __YYYCZ_SUDOKU_CANONICAL_H__
+#define __YYYCZ_SUDOKU_CANONICAL_H__
+
+#include "FastSudoku.h"
+#include <cstdint>
+#include <vector>
+
+namespace YYYCZ {
+	// a tool class to get the canonical form of the sudoku,
+	// which is the minimal lexicographic form among all the symmetry forms
+	// (transpose, band/stack/row/column permutations and digit relabeling).
+	// blanks sort after all digits.
+	// only 4*4 and 9*9 forms do geometric canonicalization,
+	// bigger forms only relabel the digits.
+	// NOT THREAD SAFE
+	class SudokuCanonical {
+	public:
+		using save_t = FastSudoku::save_t;
+		using index_t = FastSudoku::index_t;
+
+		// 128 bits hash of the canonical form
+		struct Hash {
+			uint64_t high = 0;
+			uint64_t low = 0;
+
+			bool operator==(const Hash& other) const { return high == other.high && low == other.low; }
+			bool operator!=(const Hash& other) const { return !(*this == other); }
+		};
+
+		// the symmetry transform from the original form to the canonical form:
+		// canonical[i][j] = relabel[original'[rowOrder[i]][columnOrder[j]]],
+		// original' is the transpose of original if transpose is true
+		struct Transform {
+			bool transpose = false;
+			std::vector<index_t> rowOrder;
+			std::vector<index_t> columnOrder;
+			std::vector<save_t> relabel; // relabel[0] is always 0
+
+			std::vector<save_t> apply(const std::vector<save_t>& form) const; // original -> canonical
+			std::vector<save_t> revert(const std::vector<save_t>& form) const; // canonical -> original
+		};
+
+	private:
+		static constexpr index_t SearchLength = 9; // the max length to search the minimal form, the buffers of rows are fixed
+
+		// a partial transform when searching the minimal form
+		struct State {
+			uint64_t key = 0; // to remove the duplicate states
+			uint8_t transpose = 0;
+			uint16_t columnPerm = 0;
+			uint8_t next = 1; // next label
+			uint8_t rows[SearchLength] = {};
+			uint8_t labels[SearchLength + 1] = {};
+		};
+
+		index_t formDim = 0; // the dimension of the form
+		index_t formLength = 0; // the length of the form
+		std::vector<save_t> result; // the canonical form
+		Transform transform; // the transform to canonical form
+		Hash hash; // the hash of canonical form
+
+		std::vector<save_t> sources[2]; // the form and its transpose
+		std::vector<State> states; // states of now level
+		std::vector<State> nextStates; // states of next level
+		std::vector<save_t> best; // best row of now level
+		index_t cachedDim = 0; // the dimension of cached permutations
+		std::vector<std::vector<uint16_t>> bestPerms; // the permutations making the best first row, by blank mask
+		std::vector<bool> bestPermsReady; // if the permutations of the blank mask are cached
+
+		static const std::vector<std::vector<uint8_t>>& columnPerms(index_t dim);
+		void relabelOnly(const std::vector<save_t>& form);
+		void searchMinimal(const std::vector<save_t>& form);
+
+	public:
+		SudokuCanonical& canonicalize(const std::vector<save_t>& form);
+		const std::vector<save_t>& getResult() const;
+		const Transform& getTransform() const;
+		Hash getHash() const;
+
+		static Hash hashForm(const std::vector<save_t>& form);
+	};
+}
+
+namespace std {
+	template<>
+	struct hash<YYYCZ::SudokuCanonical::Hash> {
+		size_t operator()(const YYYCZ::SudokuCanonical::Hash& h) const { return (size_t)(h.low ^ (h.high * 0x9E3779B97F4A7C15ull)); }
+	};
+}
+
+#endif
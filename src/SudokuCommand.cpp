@@ -0,0 +1,961 @@
+﻿// Code By YYYCZ
+
+#include "SudokuCommand.h"
+#include "SudokuPipeline.h"
+#include "SudokuCache.h"
+#include "SudokuIO.h"
+#include "SudokuCorpus.h"
+#include "SudokuSat.h"
+#include "SudokuSelector.h"
+#include "SudokuValidator.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <unordered_set>
+
+namespace YYYCZ {
+	/// <summary>
+	/// judge if the option is given
+	/// </summary>
+	/// <param name="name">name of option</param>
+	/// <returns>if is given</returns>
+	bool CommandArguments::has(const std::string& name) const
+	{
+		return options.count(name) != 0;
+	}
+
+	/// <summary>
+	/// get the value of option
+	/// </summary>
+	/// <param name="name">name of option</param>
+	/// <param name="defaultValue">value if not given</param>
+	/// <returns>value</returns>
+	std::string CommandArguments::get(const std::string& name, const std::string& defaultValue) const
+	{
+		auto itr = options.find(name);
+		return itr == options.end() ? defaultValue : itr->second;
+	}
+
+	/// <summary>
+	/// get the integer value of option
+	/// </summary>
+	/// <param name="name">name of option</param>
+	/// <param name="defaultValue">value if not given</param>
+	/// <returns>value</returns>
+	long long CommandArguments::getInt(const std::string& name, long long defaultValue) const
+	{
+		auto itr = options.find(name);
+		return (itr == options.end() || itr->second.empty()) ? defaultValue : std::atoll(itr->second.c_str());
+	}
+
+	/// <summary>
+	/// get the real value of option
+	/// </summary>
+	/// <param name="name">name of option</param>
+	/// <param name="defaultValue">value if not given</param>
+	/// <returns>value</returns>
+	double CommandArguments::getDouble(const std::string& name, double defaultValue) const
+	{
+		auto itr = options.find(name);
+		return (itr == options.end() || itr->second.empty()) ? defaultValue : std::atof(itr->second.c_str());
+	}
+
+	/// <summary>
+	/// judge if write the binary corpus, by the flag or the extension ".ysdk"
+	/// </summary>
+	/// <param name="args">arguments</param>
+	/// <param name="output">output file</param>
+	/// <returns>if write the corpus</returns>
+	static bool isCorpusOutput(const CommandArguments& args, const std::string& output)
+	{
+		const std::string extension = ".ysdk";
+		return args.has("binary") || (output.size() > extension.size()
+			&& output.compare(output.size() - extension.size(), extension.size(), extension) == 0);
+	}
+
+	// the output of the sudokus, text or binary corpus
+	class FormOutput {
+		std::unique_ptr<PuzzleWriter> textWriter;
+		std::unique_ptr<CorpusWriter> corpusWriter;
+
+	public:
+		/// <summary>
+		/// open the output by the arguments
+		/// </summary>
+		/// <param name="args">arguments</param>
+		/// <param name="output">output file, "-" for stdout (text only)</param>
+		/// <returns>if open successfully</returns>
+		bool open(const CommandArguments& args, const std::string& output)
+		{
+			if (isCorpusOutput(args, output)) {
+				corpusWriter.reset(new CorpusWriter(output, (FastSudoku::index_t)args.getInt("block", 4096), !args.has("raw")));
+				return corpusWriter->isOpen();
+			}
+			textWriter.reset(new PuzzleWriter(output, args.has("grid") ? PuzzleWriter::Format_Grid : PuzzleWriter::Format_Line));
+			return textWriter->isOpen();
+		}
+
+		/// <summary>
+		/// write one sudoku
+		/// </summary>
+		/// <param name="form">the form</param>
+		/// <param name="alphabet">the alphabet of text, PuzzleReader::Alphabet_*</param>
+		void write(const std::vector<FastSudoku::save_t>& form, char alphabet = PuzzleReader::Alphabet_Digits)
+		{
+			if (corpusWriter) corpusWriter->write(form);
+			else if (textWriter) textWriter->setAlphabet(alphabet).write(form);
+		}
+
+		/// <summary>
+		/// finish the output
+		/// </summary>
+		/// <returns>if write successfully</returns>
+		bool close()
+		{
+			if (corpusWriter) return corpusWriter->close();
+			if (textWriter) return textWriter->flush().good();
+			return true;
+		}
+	};
+
+	// the policies of search by name
+	struct SearchPolicy {
+		const char* name;
+		char cellPolicy;
+		char valuePolicy;
+	};
+	static const SearchPolicy policies[] = {
+		{ "mrv", FastSudoku::CellPolicy_MinimumChoices, FastSudoku::ValuePolicy_SetOrder },
+		{ "mrv+lcv", FastSudoku::CellPolicy_MinimumChoices, FastSudoku::ValuePolicy_LeastConstraining },
+		{ "mrv+freq", FastSudoku::CellPolicy_MinimumChoices, FastSudoku::ValuePolicy_Frequency },
+		{ "degree", FastSudoku::CellPolicy_Degree, FastSudoku::ValuePolicy_SetOrder },
+		{ "degree+lcv", FastSudoku::CellPolicy_Degree, FastSudoku::ValuePolicy_LeastConstraining },
+		{ "degree+freq", FastSudoku::CellPolicy_Degree, FastSudoku::ValuePolicy_Frequency },
+	};
+
+	/// <summary>
+	/// set the policy of search by name
+	/// </summary>
+	/// <param name="name">name of policy</param>
+	/// <param name="options">the options to set</param>
+	/// <returns>if the name is known</returns>
+	static bool setSearchPolicy(const std::string& name, FastSudoku::SolveOptions& options)
+	{
+		for (auto& policy : policies) {
+			if (name == policy.name) {
+				options.cellPolicy = policy.cellPolicy;
+				options.valuePolicy = policy.valuePolicy;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/// <summary>
+	/// get the layout of blocks: "--box RxC" for the boxes of R rows and C columns,
+	/// or "--regions file" for the jigsaw regions, a char for the region of a place
+	/// </summary>
+	/// <param name="args">arguments</param>
+	/// <param name="geometry">the layout, null for the standard boxes</param>
+	/// <returns>false if the layout is bad</returns>
+	static bool loadGeometry(const CommandArguments& args, std::shared_ptr<const SudokuGeometry>& geometry)
+	{
+		geometry.reset();
+		if (args.has("box")) {
+			unsigned int rows = 0, columns = 0;
+			char separator = 0;
+			if (sscanf(args.get("box").c_str(), "%u%c%u", &rows, &separator, &columns) != 3 || separator != 'x') return false;
+			geometry = SudokuGeometry::boxes(rows, columns);
+			return geometry != nullptr;
+		}
+		if (args.has("regions")) {
+			MappedFile file;
+			if (!file.open(args.get("regions"))) return false;
+			geometry = SudokuGeometry::parse(std::string(file.view()));
+			return geometry != nullptr;
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// get the rules of variant from "--variant file", one rule a line:
+	/// "diagonals", "anti-king", "anti-knight" or "cage SUM r1c1 r1c2 ..."
+	/// </summary>
+	/// <param name="args">arguments</param>
+	/// <param name="variant">the rules, null if none</param>
+	/// <returns>false if the rules are bad</returns>
+	static bool loadVariant(const CommandArguments& args, std::shared_ptr<const SudokuVariant>& variant)
+	{
+		variant.reset();
+		if (!args.has("variant")) return true;
+		MappedFile file;
+		if (!file.open(args.get("variant"))) return false;
+		variant = SudokuVariant::parse(std::string(file.view()));
+		return variant != nullptr;
+	}
+
+	/// <summary>
+	/// solve all the sudokus of a file
+	/// </summary>
+	/// <param name="args">arguments</param>
+	/// <returns>exit code</returns>
+	static int commandSolve(const CommandArguments& args)
+	{
+		if (args.positional.empty()) return 2;
+
+		std::unique_ptr<SolutionCache> cache;
+		if (args.has("cache")) {
+			cache.reset(new SolutionCache((FastSudoku::index_t)args.getInt("cache-size", 1 << 16), 16, args.get("cache")));
+		}
+
+		// the limits of every sudoku
+		FastSudoku::SolveOptions options;
+		options.timeLimit = args.getDouble("time-limit", 0) / 1000;
+		options.maxNodes = (FastSudoku::index_t)args.getInt("max-nodes", 0);
+
+		// restart the heavy searches with random choices
+		const std::string restart = args.get("restart");
+		if (restart == "luby") options.restart = FastSudoku::Restart_Luby;
+		else if (restart == "geometric") options.restart = FastSudoku::Restart_Geometric;
+		else if (!restart.empty()) return 2;
+		options.seed = (unsigned int)args.getInt("seed", 0);
+		options.restartBase = (FastSudoku::index_t)args.getInt("restart-base", options.restartBase);
+
+		// the policy of search
+		if (!setSearchPolicy(args.get("policy", "mrv"), options)) return 2;
+		if (args.has("hidden-singles")) options.propagation = FastSudoku::Propagation_HiddenSingles;
+		if (args.has("naked-singles")) options.propagation = FastSudoku::Propagation_NakedSingles;
+		options.learning = args.has("learning");
+		const std::string backend = args.get("backend", "search");
+		if (backend == "sat") options.backend = FastSudoku::Backend_Sat;
+		else if (backend == "annealing") options.backend = FastSudoku::Backend_Annealing;
+		else if (backend == "auto") options.backend = FastSudoku::Backend_Auto;
+		else if (backend != "search") return 2;
+		if (!loadGeometry(args, options.geometry)) {
+			fprintf(stderr, "Bad layout of blocks.\n");
+			return 1;
+		}
+		if (!loadVariant(args, options.variant)
+			|| (options.variant && options.geometry && !options.variant->tablesOf(options.geometry->getLength()).valid)) {
+			fprintf(stderr, "Bad rules of variant.\n");
+			return 1;
+		}
+		if (args.has("selector") && !(options.selector = SudokuSelector::load(args.get("selector")))) {
+			fprintf(stderr, "Bad model of selector.\n");
+			return 1;
+		}
+
+		// the sudokus estimated heavy are solved by another backend, or by restarts of random choices
+		FastSudoku::SolveOptions heavyOptions = options;
+		const std::string heavyBackend = args.get("heavy-backend", "sat");
+		if (heavyBackend == "sat") heavyOptions.backend = FastSudoku::Backend_Sat;
+		else if (heavyBackend == "restart") {
+			heavyOptions.restart = FastSudoku::Restart_Luby;
+			heavyOptions.tieBreak = FastSudoku::TieBreak_Random;
+			heavyOptions.valueOrder = FastSudoku::ValueOrder_Random;
+		}
+		else return 2;
+
+		const std::string output = args.positional.size() > 1 ? args.positional[1] : "-";
+		SolvePipeline pipeline;
+		pipeline.setValidation(!args.has("no-validate"));
+		pipeline.setWorkerCount((FastSudoku::index_t)args.getInt("threads", 0))
+			.setQueueSize((FastSudoku::index_t)args.getInt("queue", 64))
+			.setChunkSize((FastSudoku::index_t)args.getInt("chunk", 64))
+			.setOutputFormat(args.has("grid") ? PuzzleWriter::Format_Grid : PuzzleWriter::Format_Line)
+			.setCorpusOutput(isCorpusOutput(args, output))
+			.setSolutionCache(cache.get())
+			.setSolveOptions(options)
+			.setHeavyRoute(args.getDouble("heavy-nodes", 0), heavyOptions, (FastSudoku::index_t)args.getInt("probes", 16));
+
+		if (!pipeline.run(args.positional[0], output)) {
+			fprintf(stderr, !pipeline.isVariantGood() ? "Bad rules of variant.\n"
+				: !pipeline.isOutputGood() ? "Can't write the file.\n" : "Can't open the file.\n");
+			return 1;
+		}
+		if (!args.has("quiet")) {
+			pipeline.printReport(stderr);
+			if (cache) fprintf(stderr, "cache %llu hits, %llu misses\n", cache->getHitTimes(), cache->getMissTimes());
+		}
+		return 0;
+	}
+
+	/// <summary>
+	/// convert the sudokus between text and binary corpus
+	/// </summary>
+	/// <param name="args">arguments</param>
+	/// <returns>exit code</returns>
+	static int commandConvert(const CommandArguments& args)
+	{
+		if (args.positional.size() < 2) return 2;
+		const std::string& input = args.positional[0];
+		const std::string& output = args.positional[1];
+
+		CorpusReader corpus;
+		std::string_view text;
+		MappedFile file;
+		if (CorpusReader::isCorpus(input)) {
+			if (!corpus.open(input)) {
+				fprintf(stderr, "Bad corpus file.\n");
+				return 1;
+			}
+		}
+		else if (file.open(input)) {
+			text = file.view();
+		}
+		else {
+			fprintf(stderr, "Can't open the file.\n");
+			return 1;
+		}
+
+		FormOutput out;
+		if (!out.open(args, output)) {
+			fprintf(stderr, "Can't open the file.\n");
+			return 1;
+		}
+		// a bad sudoku is written as an empty form (an empty line of text), so the order is the same as solve keeps
+		unsigned long long count = 0, bad = 0;
+		if (corpus.isOpen()) {
+			std::vector<std::vector<FastSudoku::save_t>> forms;
+			for (FastSudoku::index_t b = 0; b < corpus.getBlockCount(); ++b) {
+				if (corpus.readBlock(b, forms)) {
+					count += forms.size();
+				}
+				else {
+					const size_t items = (size_t)std::min<uint64_t>(corpus.getBlockSize(), corpus.getCount() - (uint64_t)b * corpus.getBlockSize());
+					forms.assign(items, std::vector<FastSudoku::save_t>());
+					bad += items;
+				}
+				for (auto& form : forms) out.write(form);
+			}
+		}
+		else {
+			PuzzleReader reader(text);
+			std::vector<FastSudoku::save_t> form;
+			const std::vector<FastSudoku::save_t> empty;
+			while (true) {
+				const bool read = reader.next(form);
+				for (; bad < reader.getErrorCount(); ++bad) out.write(empty);
+				if (!read) break;
+				out.write(form, reader.getAlphabet());
+				++count;
+			}
+		}
+
+		if (!out.close()) {
+			fprintf(stderr, "Can't write the file.\n");
+			return 1;
+		}
+		if (!args.has("quiet")) fprintf(stderr, "%llu sudokus converted, %llu bad\n", count, bad);
+		return 0;
+	}
+
+	/// <summary>
+	/// generate the sudokus into a file
+	/// </summary>
+	/// <param name="args">arguments</param>
+	/// <returns>exit code</returns>
+	static int commandGenerate(const CommandArguments& args)
+	{
+		if (args.positional.empty()) return 2;
+		const long long count = std::atoll(args.positional[0].c_str());
+		const std::string output = args.positional.size() > 1 ? args.positional[1] : "-";
+		const FastSudoku::save_t dim = (FastSudoku::save_t)args.getInt("dim", 3);
+		const FastSudoku::index_t numbers = (FastSudoku::index_t)args.getInt("numbers", 30);
+		if (count <= 0 || dim <= 1) return 2;
+
+		FormOutput out;
+		if (!out.open(args, output)) {
+			fprintf(stderr, "Can't open the file.\n");
+			return 1;
+		}
+
+		FastSudoku generator;
+		for (long long i = 0; i < count; ++i) {
+			generator.generate(numbers, dim);
+			out.write(generator.getResult());
+		}
+		if (!out.close()) {
+			fprintf(stderr, "Can't write the file.\n");
+			return 1;
+		}
+		return 0;
+	}
+
+	/// <summary>
+	/// read the sudokus of a text file or a corpus
+	/// </summary>
+	/// <param name="input">the file</param>
+	/// <param name="forms">the sudokus</param>
+	/// <param name="limit">the count at most, 0 for all</param>
+	/// <param name="alphabets">the alphabet of every sudoku if not null, Alphabet_Digits for the corpus</param>
+	/// <returns>if read successfully</returns>
+	static bool loadForms(const std::string& input, std::vector<std::vector<FastSudoku::save_t>>& forms, size_t limit,
+		std::string* alphabets = nullptr)
+	{
+		forms.clear();
+		if (alphabets) alphabets->clear();
+		if (CorpusReader::isCorpus(input)) {
+			CorpusReader corpus;
+			if (!corpus.open(input)) return false;
+			std::vector<std::vector<FastSudoku::save_t>> block;
+			for (FastSudoku::index_t b = 0; b < corpus.getBlockCount() && (!limit || forms.size() < limit); ++b) {
+				corpus.readBlock(b, block);
+				for (auto& form : block) {
+					if (limit && forms.size() >= limit) break;
+					forms.push_back(std::move(form));
+				}
+			}
+			if (alphabets) alphabets->assign(forms.size(), PuzzleReader::Alphabet_Digits);
+			return true;
+		}
+
+		MappedFile file;
+		if (!file.open(input)) return false;
+		PuzzleReader reader(file.view());
+		std::vector<FastSudoku::save_t> form;
+		while ((!limit || forms.size() < limit) && reader.next(form)) {
+			forms.push_back(form);
+			if (alphabets) alphabets->push_back(reader.getAlphabet());
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// write the CNF of a sudoku as DIMACS, to compare with other SAT solvers
+	/// </summary>
+	/// <param name="args">arguments</param>
+	/// <returns>exit code</returns>
+	static int commandCnf(const CommandArguments& args)
+	{
+		if (args.positional.empty()) return 2;
+		const size_t index = (size_t)args.getInt("index", 0);
+
+		std::vector<std::vector<FastSudoku::save_t>> forms;
+		if (!loadForms(args.positional[0], forms, index + 1)) {
+			fprintf(stderr, "Can't open the file.\n");
+			return 1;
+		}
+		std::shared_ptr<const SudokuGeometry> geometry;
+		if (!loadGeometry(args, geometry)) {
+			fprintf(stderr, "Bad layout of blocks.\n");
+			return 1;
+		}
+		SudokuCnf cnf;
+		if (forms.size() <= index || !cnf.encode(forms[index], geometry.get())) {
+			fprintf(stderr, "No such sudoku.\n");
+			return 1;
+		}
+
+		const std::string output = args.positional.size() > 1 ? args.positional[1] : "-";
+		std::ofstream file;
+		if (output != "-") {
+			file.open(output);
+			if (!file) {
+				fprintf(stderr, "Can't open the file.\n");
+				return 1;
+			}
+		}
+		cnf.writeDimacs(output == "-" ? std::cout : file);
+		if (!args.has("quiet")) fprintf(stderr, "%u variables, %u clauses\n", cnf.getVariableCount(), cnf.getClauseCount());
+		return 0;
+	}
+
+	/// <summary>
+	/// enumerate all the solutions of a sudoku, one line a solution.
+	/// with a checkpoint file the state is saved every some seconds, and --resume continues from it:
+	/// the output is cut to the size when saved, so the solutions after it are not written twice
+	/// </summary>
+	/// <param name="args">arguments</param>
+	/// <returns>exit code</returns>
+	static int commandEnumerate(const CommandArguments& args)
+	{
+		if (args.positional.empty()) return 2;
+		const size_t index = (size_t)args.getInt("index", 0);
+
+		std::vector<std::vector<FastSudoku::save_t>> forms;
+		std::string alphabets;
+		if (!loadForms(args.positional[0], forms, index + 1, &alphabets)) {
+			fprintf(stderr, "Can't open the file.\n");
+			return 1;
+		}
+		if (forms.size() <= index) {
+			fprintf(stderr, "No such sudoku.\n");
+			return 1;
+		}
+		std::shared_ptr<const SudokuGeometry> geometry;
+		if (!loadGeometry(args, geometry)) {
+			fprintf(stderr, "Bad layout of blocks.\n");
+			return 1;
+		}
+
+		FastSudoku::EnumerateOptions options;
+		options.maxSolutions = (unsigned long long)args.getInt("max", 0);
+		options.timeLimit = args.getDouble("time-limit", 0) / 1000;
+		options.checkpointFile = args.get("checkpoint");
+		options.checkpointSeconds = args.getDouble("checkpoint-seconds", 60);
+		options.resume = args.has("resume");
+
+		// continue the output of the checkpoint
+		const std::string output = args.positional.size() > 1 ? args.positional[1] : "-";
+		unsigned long long written = 0;
+		FastSudoku::EnumerateCheckpoint checkpoint;
+		const bool resuming = options.resume && !options.checkpointFile.empty() && checkpoint.read(options.checkpointFile);
+		if (resuming && checkpoint.form != forms[index]) {
+			fprintf(stderr, "The checkpoint is not of this sudoku.\n");
+			return 1;
+		}
+		FILE* file = stdout;
+		if (output != "-") {
+			if (resuming) {
+				std::error_code error;
+				std::filesystem::resize_file(output, checkpoint.sinkPosition, error);
+				if (error) {
+					fprintf(stderr, "Can't continue the output.\n");
+					return 1;
+				}
+				written = checkpoint.sinkPosition;
+			}
+			file = fopen(output.c_str(), resuming ? "ab" : "wb");
+			if (!file) {
+				fprintf(stderr, "Can't open the file.\n");
+				return 1;
+			}
+		}
+
+		PuzzleWriter writer(file);
+		std::vector<char> line(PuzzleWriter::formatSize(forms[index].size(), PuzzleWriter::Format_Line));
+		options.flushSink = [&](unsigned long long& position) {
+			position = written;
+			return writer.flush().good();
+		};
+		FastSudoku enumerator;
+		enumerator.setGeometry(geometry);
+		auto result = enumerator.enumerate(forms[index], [&](const std::vector<FastSudoku::save_t>& solution) {
+			const size_t size = PuzzleWriter::formatForm(solution, line.data(), PuzzleWriter::Format_Line, alphabets[index]);
+			writer.write(std::string_view(line.data(), size));
+			written += size;
+			return writer.good();
+		}, options);
+		bool good = writer.flush().good();
+		if (file != stdout) good = fclose(file) == 0 && good;
+
+		if (!good || result.status == FastSudoku::EnumerateResult::Status_SinkFailed) {
+			fprintf(stderr, "Can't write the file.\n");
+			return 1;
+		}
+		if (result.status == FastSudoku::EnumerateResult::Status_Invalid) {
+			fprintf(stderr, "No such sudoku.\n");
+			return 1;
+		}
+		if (result.status == FastSudoku::EnumerateResult::Status_BadCheckpoint) {
+			fprintf(stderr, "The checkpoint is not of this sudoku.\n");
+			return 1;
+		}
+		if (!args.has("quiet")) {
+			fprintf(stderr, "%llu solutions, %llu nodes, %.3f s%s%s\n", result.solutions, result.nodes, result.seconds,
+				result.resumed ? ", resumed" : "",
+				result.status == FastSudoku::EnumerateResult::Status_Stopped ? ", stopped (continue by --resume)" : "");
+		}
+		return 0;
+	}
+
+	/// <summary>
+	/// estimate the full search tree of every sudoku by random probes, one line a sudoku: "index tree-nodes tree-seconds deviation".
+	/// the tree is of all the solutions, not the cost of solving; sorted by the nodes, the heaviest first
+	/// </summary>
+	/// <param name="args">arguments</param>
+	/// <returns>exit code</returns>
+	static int commandEstimate(const CommandArguments& args)
+	{
+		if (args.positional.empty()) return 2;
+
+		std::vector<std::vector<FastSudoku::save_t>> forms;
+		if (!loadForms(args.positional[0], forms, 0)) {
+			fprintf(stderr, "Can't open the file.\n");
+			return 1;
+		}
+		FastSudoku::EstimateOptions options;
+		options.probes = (FastSudoku::index_t)args.getInt("probes", options.probes);
+		options.timeLimit = args.getDouble("time-limit", 0) / 1000;
+		options.seed = (unsigned int)args.getInt("seed", 0);
+		if (!loadGeometry(args, options.geometry)) {
+			fprintf(stderr, "Bad layout of blocks.\n");
+			return 1;
+		}
+
+		FastSudoku estimator;
+		std::vector<std::pair<size_t, FastSudoku::EstimateResult>> estimates;
+		double nodes = 0, treeSeconds = 0, probeSeconds = 0;
+		for (size_t i = 0; i < forms.size(); ++i) {
+			auto result = estimator.estimate(forms[i], options);
+			if (!result.valid) continue;
+			nodes += result.nodes;
+			treeSeconds += result.treeSeconds;
+			probeSeconds += result.probeSeconds;
+			estimates.emplace_back(i, result);
+		}
+		if (args.has("sort")) {
+			std::stable_sort(estimates.begin(), estimates.end(), [](const auto& a, const auto& b) {
+				return a.second.nodes > b.second.nodes;
+			});
+		}
+
+		const std::string output = args.positional.size() > 1 ? args.positional[1] : "-";
+		FILE* file = output == "-" ? stdout : fopen(output.c_str(), "wb");
+		if (!file) {
+			fprintf(stderr, "Can't open the file.\n");
+			return 1;
+		}
+		for (auto& estimate : estimates) {
+			fprintf(file, "%zu %.0f %.6f %.0f\n", estimate.first, estimate.second.nodes, estimate.second.treeSeconds, estimate.second.deviation);
+		}
+		if (file != stdout) fclose(file);
+
+		if (!args.has("quiet")) {
+			fprintf(stderr, "%zu sudokus (%zu bad), full trees estimated %.0f nodes and %.3f s in all, probed in %.3f s\n",
+				estimates.size(), forms.size() - estimates.size(), nodes, treeSeconds, probeSeconds);
+		}
+		return 0;
+	}
+
+	/// <summary>
+	/// validate the sudokus without search, one line a bad sudoku (or every one by --all):
+	/// "index status place number unit givens filled", the unit is rows, columns, then blocks from 0
+	/// </summary>
+	/// <param name="args">arguments</param>
+	/// <returns>exit code</returns>
+	static int commandValidate(const CommandArguments& args)
+	{
+		if (args.positional.empty()) return 2;
+		SudokuValidator validator;
+		std::shared_ptr<const SudokuGeometry> geometry;
+		if (!loadGeometry(args, geometry)) {
+			fprintf(stderr, "Bad layout of blocks.\n");
+			return 1;
+		}
+		validator.setGeometry(geometry);
+
+		const std::string output = args.positional.size() > 1 ? args.positional[1] : "-";
+		FILE* file = output == "-" ? stdout : fopen(output.c_str(), "wb");
+		if (!file) {
+			fprintf(stderr, "Can't open the file.\n");
+			return 1;
+		}
+
+		// the sudokus are streamed, not loaded all
+		const bool all = args.has("all");
+		size_t index = 0, counts[SudokuValidator::Status_NoPlace + 1] = {};
+		const auto tpBegin = FastSudoku::clock_t::now();
+		auto check = [&](const std::vector<FastSudoku::save_t>& form) {
+			auto report = validator.validate(form);
+			++counts[(int)report.status];
+			if (all || !report.isValid()) {
+				fprintf(file, "%zu %s %u %d %u %u %u\n", index, SudokuValidator::nameOf(report.status),
+					report.place, report.number, report.unit, report.givens, report.filled);
+			}
+			++index;
+		};
+
+		bool opened = true;
+		const std::string input = args.positional[0];
+		if (CorpusReader::isCorpus(input)) {
+			CorpusReader corpus;
+			opened = corpus.open(input);
+			std::vector<std::vector<FastSudoku::save_t>> block;
+			for (FastSudoku::index_t b = 0; opened && b < corpus.getBlockCount(); ++b) {
+				corpus.readBlock(b, block);
+				for (auto& form : block) check(form);
+			}
+		}
+		else {
+			MappedFile mapped;
+			opened = mapped.open(input);
+			PuzzleReader reader(opened ? mapped.view() : std::string_view());
+			std::vector<FastSudoku::save_t> form;
+			while (opened && reader.next(form)) check(form);
+		}
+		if (file != stdout) fclose(file);
+		if (!opened) {
+			fprintf(stderr, "Can't open the file.\n");
+			return 1;
+		}
+
+		if (!args.has("quiet")) {
+			const double seconds = std::chrono::duration<double>(FastSudoku::clock_t::now() - tpBegin).count();
+			fprintf(stderr, "%zu sudokus in %.3f s (%.0f /s):", index, seconds, seconds > 0 ? index / seconds : 0.0);
+			for (char status = 0; status <= SudokuValidator::Status_NoPlace; ++status) {
+				fprintf(stderr, " %zu %s%s", counts[(int)status], SudokuValidator::nameOf(status),
+					status == SudokuValidator::Status_NoPlace ? "\n" : ",");
+			}
+		}
+		return 0;
+	}
+
+	/// <summary>
+	/// calibrate the model of selector: solve the sudokus of the inputs by every engine (one thread without cache),
+	/// fit the cost of engines by the features, and save the model. the mix of inputs should be like the sudokus to solve
+	/// </summary>
+	/// <param name="args">arguments</param>
+	/// <returns>exit code</returns>
+	static int commandCalibrate(const CommandArguments& args)
+	{
+		if (args.positional.size() < 2) return 2;
+		const FastSudoku::index_t probes = (FastSudoku::index_t)args.getInt("probes", 0);
+		const double timeLimit = args.getDouble("time-limit", 1000) / 1000;
+
+		// the engines to measure, all by default
+		std::vector<char> engines;
+		std::string names = args.get("engines", "search,learning,sat,annealing");
+		for (size_t begin = 0; begin <= names.size();) {
+			size_t end = names.find(',', begin);
+			if (end == std::string::npos) end = names.size();
+			const char engine = SudokuSelector::engineOf(names.substr(begin, end - begin));
+			if (engine < 0) return 2;
+			engines.push_back(engine);
+			begin = end + 1;
+		}
+		std::shared_ptr<const SudokuGeometry> geometry;
+		if (!loadGeometry(args, geometry)) {
+			fprintf(stderr, "Bad layout of blocks.\n");
+			return 1;
+		}
+
+		FastSudoku solver;
+		std::vector<SudokuSelector::Sample> samples;
+		for (size_t input = 1; input < args.positional.size(); ++input) {
+			std::vector<std::vector<FastSudoku::save_t>> forms;
+			if (!loadForms(args.positional[input], forms, (size_t)args.getInt("count", 200))) {
+				fprintf(stderr, "Can't open the file.\n");
+				return 1;
+			}
+			for (auto& form : forms) {
+				SudokuSelector::Sample sample;
+				sample.features = solver.measure(form, probes, geometry);
+				if (sample.features.length == 0) continue;
+				sample.seconds.fill(-1);
+				for (char engine : engines) {
+					FastSudoku::SolveOptions options;
+					options.useCache = false;
+					options.timeLimit = timeLimit;
+					options.geometry = geometry;
+					options.backend = engine == SudokuSelector::Engine_Sat ? FastSudoku::Backend_Sat
+						: engine == SudokuSelector::Engine_Annealing ? FastSudoku::Backend_Annealing : FastSudoku::Backend_Search;
+					options.learning = engine == SudokuSelector::Engine_Learning;
+					auto result = solver.solve(form, options);
+					sample.seconds[engine] = result.seconds;
+					sample.solved[engine] = result.status == FastSudoku::SolveResult::Status_Solved
+						|| result.status == FastSudoku::SolveResult::Status_NoSolution;
+				}
+				samples.push_back(sample);
+			}
+		}
+		if (samples.empty()) {
+			fprintf(stderr, "No sudoku to calibrate.\n");
+			return 1;
+		}
+
+		// the penalty of a sudoku over the limit is some times of the limit
+		const double penalty = 4 * timeLimit;
+		SudokuSelector selector;
+		selector.setProbes(probes).calibrate(samples, penalty);
+		if (!selector.save(args.positional[0])) {
+			fprintf(stderr, "Can't save the model.\n");
+			return 1;
+		}
+
+		// the time of every engine for all, of the choices of model, and of the best choices
+		if (!args.has("quiet")) {
+			auto costOf = [&](const SudokuSelector::Sample& sample, char engine) {
+				return sample.solved[engine] ? sample.seconds[engine] : penalty;
+			};
+			double chosen = 0, best = 0;
+			for (auto& sample : samples) {
+				chosen += costOf(sample, selector.choose(sample.features));
+				double least = penalty;
+				for (char engine : engines) least = std::min(least, costOf(sample, engine));
+				best += least;
+			}
+			fprintf(stderr, "%-10s %10s %10s\n", "engine", "over(lim)", "total(s)");
+			for (char engine : engines) {
+				double total = 0;
+				size_t over = 0;
+				for (auto& sample : samples) {
+					total += costOf(sample, engine);
+					if (!sample.solved[engine]) ++over;
+				}
+				fprintf(stderr, "%-10s %10zu %10.3f\n", SudokuSelector::nameOf(engine), over, total);
+			}
+			fprintf(stderr, "%zu sudokus, %.3f s by the model, %.3f s by the best choices\n", samples.size(), chosen, best);
+		}
+		return 0;
+	}
+
+	/// <summary>
+	/// measure the policies of search on the sudokus, one thread without cache
+	/// </summary>
+	/// <param name="args">arguments</param>
+	/// <returns>exit code</returns>
+	static int commandBench(const CommandArguments& args)
+	{
+		if (args.positional.empty()) return 2;
+
+		std::vector<std::vector<FastSudoku::save_t>> forms;
+		if (!loadForms(args.positional[0], forms, (size_t)args.getInt("count", 0))) {
+			fprintf(stderr, "Can't open the file.\n");
+			return 1;
+		}
+
+		fprintf(stdout, "%zu sudokus\n", forms.size());
+		fprintf(stdout, "%-12s %-7s %8s %10s %8s %8s %8s %10s %10s\n",
+			"policy", "singles", "solved", "nodes", "p50", "p99", "max", "time(s)", "rate(/s)");
+		FastSudoku solver;
+		for (char propagation : { FastSudoku::Propagation_NakedSingles, FastSudoku::Propagation_HiddenSingles }) {
+			for (auto& policy : policies) {
+				FastSudoku::SolveOptions options;
+				options.useCache = false;
+				options.maxNodes = (FastSudoku::index_t)args.getInt("max-nodes", 0);
+				options.propagation = propagation;
+				options.cellPolicy = policy.cellPolicy;
+				options.valuePolicy = policy.valuePolicy;
+
+				std::vector<FastSudoku::index_t> nodes;
+				unsigned long long totalNodes = 0, solved = 0;
+				double seconds = 0;
+				for (auto& form : forms) {
+					auto result = solver.solve(form, options);
+					solved += result.isSolved();
+					nodes.push_back(result.iterations);
+					totalNodes += result.iterations;
+					seconds += result.seconds;
+				}
+				std::sort(nodes.begin(), nodes.end());
+				auto percentile = [&](double p) { return nodes.empty() ? 0 : nodes[(size_t)(p * (nodes.size() - 1))]; };
+				fprintf(stdout, "%-12s %-7s %8llu %10llu %8u %8u %8u %10.3f %10.0f\n", policy.name,
+					propagation == FastSudoku::Propagation_HiddenSingles ? "hidden" : "naked",
+					solved, totalNodes, percentile(0.5), percentile(0.99), percentile(1), seconds,
+					seconds > 0 ? forms.size() / seconds : 0.0);
+			}
+		}
+		return 0;
+	}
+
+	// the command line tools
+	struct Command {
+		const char* name;
+		const char* usage;
+		int (*run)(const CommandArguments& args);
+	};
+
+	static const Command commands[] = {
+		{ "solve", "solve <input> [output] [--threads N] [--queue N] [--chunk N] [--grid] [--binary] [--cache file] [--cache-size N]\n"
+			"        [--time-limit MS] [--max-nodes N] [--restart luby|geometric] [--restart-base N] [--seed N]\n"
+			"        [--policy name] [--hidden-singles] [--naked-singles] [--learning] [--backend search|sat|annealing|auto] [--selector model]\n"
+			"        [--box RxC] [--regions file] [--variant file] [--no-validate] [--heavy-nodes N] [--heavy-backend sat|restart] [--probes N] [--quiet]\n"
+			"    solve all the sudokus of input (\"-\" for stdin), write the solutions to output in order,\n"
+			"    an empty line for no solution, and print the throughput of every stage.\n"
+			"    a sudoku over the time limit or the max nodes is given up, also an empty line.\n"
+			"    --restart searches again with random choices after the nodes of the schedule,\n"
+			"    --policy is one of the policies of bench, and --hidden-singles fills the numbers with one place,\n"
+			"    --learning jumps back to the cause of a conflict and learns it (for the large or hard sudokus),\n"
+			"    it fills the hidden singles too unless --naked-singles, without them the causes are too wide to help,\n"
+			"    --backend sat encodes the sudokus as CNF and solves them by the CDCL solver (for 36x36 and larger),\n"
+			"    --backend annealing fills the blocks and swaps the numbers until no conflict (for 49x49 and larger with few numbers)\n"
+			"    --backend auto chooses one of them for every sudoku, by the model of calibrate or by the size without --selector\n"
+			"    --box RxC sets the boxes of R rows and C columns (2x3 for 6x6 and 3x4 for 12x12 are the default),\n"
+			"    --regions reads the jigsaw regions from the file, a char for the region of a place by rows,\n"
+			"    --variant reads the rules from the file, one a line: diagonals, anti-king, anti-knight or cage SUM r1c1 r1c2 ...\n"
+			"    (the variants are solved by the search backend without learning)\n"
+			"    the sudokus are validated first, the contradictory ones are given up without search (--no-validate not to),\n"
+			"    --heavy-nodes estimates the full search tree of every sudoku by N probes (16 by default, see estimate),\n"
+			"    the ones over the nodes are solved by --heavy-backend: sat (the default), or restart for the search\n"
+			"    restarted with random choices. the tree of a solvable sudoku is far bigger than its solving, so set it high\n"
+			"    the input can be text or binary corpus, --binary (or output \"*.ysdk\") writes a corpus", commandSolve },
+		{ "convert", "convert <input> <output> [--binary] [--grid] [--block N] [--raw] [--quiet]\n"
+			"    convert the sudokus between text and binary corpus (4 bits a cell, block compressed unless --raw),\n"
+			"    a bad sudoku is written as an empty one (an empty line), so the lines are the same as the solutions of solve", commandConvert },
+		{ "generate", "generate <count> [output] [--dim N] [--numbers N] [--binary] [--grid] [--block N] [--raw]\n"
+			"    generate sudokus with at least N numbers given (may not unique solve)", commandGenerate },
+		{ "cnf", "cnf <input> [output] [--index N] [--box RxC] [--regions file] [--quiet]\n"
+			"    write the CNF of the Nth sudoku (from 0) of input as DIMACS, the numbers of variables are in the comments", commandCnf },
+		{ "enumerate", "enumerate <input> [output] [--index N] [--max N] [--time-limit MS] [--checkpoint file] [--checkpoint-seconds S]\n"
+			"        [--resume] [--box RxC] [--regions file] [--quiet]\n"
+			"    write all the solutions of the Nth sudoku (from 0) of input, one a line and none kept in memory.\n"
+			"    the state is saved to the checkpoint every S seconds (60 by default) and when stopped,\n"
+			"    --resume continues from the checkpoint and cuts the output to the solutions before it", commandEnumerate },
+		{ "estimate", "estimate <input> [output] [--probes N] [--time-limit MS] [--seed N] [--sort] [--box RxC] [--regions file] [--quiet]\n"
+			"    estimate the full search tree (all the solutions, as enumerate) of every sudoku by N random probes (64 by default),\n"
+			"    one line a sudoku: \"index tree-nodes tree-seconds deviation\", --sort for the heaviest first.\n"
+			"    it is not the cost of solving, the first solution is usually found in a small part of the tree", commandEstimate },
+		{ "validate", "validate <input> [output] [--all] [--box RxC] [--regions file] [--quiet]\n"
+			"    check the sudokus without search: the numbers given, then the singles filled until a contradiction or no more.\n"
+			"    one line a bad sudoku (every one by --all): \"index status place number unit givens filled\"", commandValidate },
+		{ "calibrate", "calibrate <model> <input>... [--count N] [--time-limit MS] [--probes N] [--engines list] [--box RxC] [--regions file] [--quiet]\n"
+			"    solve N sudokus (200 by default) of every input by the engines (search,learning,sat,annealing by default),\n"
+			"    each in MS (1000 by default), and save the model of costs for --backend auto --selector model.\n"
+			"    --probes adds the search tree estimated by N probes to the features", commandCalibrate },
+		{ "bench", "bench <input> [--count N] [--max-nodes N]\n"
+			"    solve the sudokus by every policy of search (one thread, no cache), and print the nodes and the time", commandBench },
+	};
+
+	// the options without value
+	static const std::unordered_set<std::string> flags = { "grid", "quiet", "binary", "raw", "hidden-singles", "naked-singles", "learning", "resume", "sort", "all", "no-validate" };
+
+	/// <summary>
+	/// print the usage of commands
+	/// </summary>
+	static void printUsage()
+	{
+		fprintf(stderr, "Usage: Sudoku <command> [arguments]\n"
+			"Run without arguments to play the game.\n\n"
+			"Commands:\n");
+		for (auto& command : commands) {
+			fprintf(stderr, "  %s\n", command.usage);
+		}
+	}
+
+	/// <summary>
+	/// run the command line tools
+	/// </summary>
+	/// <param name="argc">count of arguments</param>
+	/// <param name="argv">arguments</param>
+	/// <returns>exit code</returns>
+	int runCommand(int argc, char* argv[])
+	{
+		if (argc < 2) {
+			printUsage();
+			return 2;
+		}
+
+		// "--name value" for the options, and "--name" for the flags
+		CommandArguments args;
+		for (int i = 2; i < argc; ++i) {
+			std::string arg = argv[i];
+			if (arg.size() > 2 && arg[0] == '-' && arg[1] == '-') {
+				std::string name = arg.substr(2), value;
+				if (flags.count(name) == 0 && i + 1 < argc) {
+					value = argv[++i];
+				}
+				args.options[name] = value;
+			}
+			else {
+				args.positional.push_back(arg);
+			}
+		}
+
+		const std::string name = argv[1];
+		for (auto& command : commands) {
+			if (name == command.name) {
+				int code = command.run(args);
+				if (code == 2) fprintf(stderr, "Usage: Sudoku %s\n", command.usage);
+				return code;
+			}
+		}
+		printUsage();
+		return 2;
+	}
+}
@@ -0,0 +1,25 @@
+﻿// Code By YYYCZ
+
+#ifndef __YYYCZ_SUDOKU_COMMAND_H__
+#define __YYYCZ_SUDOKU_COMMAND_H__
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace YYYCZ {
+	// the arguments of one command: positional arguments and "--name value" options
+	struct CommandArguments {
+		std::vector<std::string> positional;
+		std::unordered_map<std::string, std::string> options;
+
+		bool has(const std::string& name) const;
+		std::string get(const std::string& name, const std::string& defaultValue = "") const;
+		long long getInt(const std::string& name, long long defaultValue = 0) const;
+		double getDouble(const std::string& name, double defaultValue = 0) const;
+	};
+
+	int runCommand(int argc, char* argv[]); // run the command line tools, return the exit code
+}
+
+#endif
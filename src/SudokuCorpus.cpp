@@ -0,0 +1,462 @@
+﻿// Code By YYYCZ
+
+#include "SudokuCorpus.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace YYYCZ {
+	namespace {
+		// write the little endian numbers
+		void putNumber(char* out, uint64_t value, size_t bytes)
+		{
+			for (size_t i = 0; i < bytes; ++i) {
+				out[i] = (char)(value >> (8 * i));
+			}
+		}
+
+		// read the little endian numbers
+		uint64_t getNumber(const char* in, size_t bytes)
+		{
+			uint64_t value = 0;
+			for (size_t i = 0; i < bytes; ++i) {
+				value |= (uint64_t)(unsigned char)in[i] << (8 * i);
+			}
+			return value;
+		}
+
+		// bits of one cell for the count of cells, the value of all bits set marks an empty form
+		uint8_t getCellBits(uint64_t size)
+		{
+			uint64_t maxNumber = (uint64_t)std::lround(std::sqrt((double)size));
+			if (maxNumber < 15) return 4;
+			if (maxNumber < 255) return 8;
+			return 16;
+		}
+
+		// bytes of one packed sudoku
+		uint64_t getPackedSize(uint64_t size, uint8_t bits)
+		{
+			return (size * bits + 7) / 8;
+		}
+
+		// compress by the run-length of zero bytes (the blanks):
+		// control byte c < 128 is followed by c + 1 literal bytes,
+		// c >= 128 means c - 127 zero bytes
+		void compressZeroRun(const std::string& in, std::string& out)
+		{
+			out.clear();
+			size_t i = 0;
+			while (i < in.size()) {
+				size_t zeros = 0;
+				while (i + zeros < in.size() && in[i + zeros] == 0 && zeros < 128) ++zeros;
+				if (zeros >= 2 || (zeros == 1 && i + 1 == in.size())) {
+					out.push_back((char)(127 + zeros));
+					i += zeros;
+					continue;
+				}
+
+				// the literals end before two zero bytes
+				size_t begin = i;
+				while (i < in.size() && i - begin < 128) {
+					if (in[i] == 0 && i + 1 < in.size() && in[i + 1] == 0) break;
+					++i;
+				}
+				out.push_back((char)(i - begin - 1));
+				out.append(in, begin, i - begin);
+			}
+		}
+
+		// decompress the run-length of zero bytes, return false if the data is bad
+		bool decompressZeroRun(std::string_view in, std::string& out, size_t rawSize)
+		{
+			out.clear();
+			out.reserve(rawSize);
+			size_t i = 0;
+			while (i < in.size()) {
+				unsigned char c = (unsigned char)in[i++];
+				if (c >= 128) {
+					out.append(c - 127, '\0');
+				}
+				else {
+					if (i + c + 1 > in.size()) return false;
+					out.append(in.data() + i, c + 1);
+					i += c + 1;
+				}
+				if (out.size() > rawSize) return false;
+			}
+			return out.size() == rawSize;
+		}
+
+		// pack one sudoku, null for an empty form (all bits set in the first cell)
+		void packForm(const FastSudoku::save_t* form, uint64_t size, uint8_t bits, std::string& out)
+		{
+			size_t begin = out.size();
+			out.resize(begin + (size_t)getPackedSize(size, bits), '\0');
+			if (size == 0) return;
+
+			char* data = &out[begin];
+			const uint64_t mask = (1ull << bits) - 1;
+			if (!form) {
+				if (bits == 4) data[0] = (char)mask;
+				else putNumber(data, mask, bits / 8);
+				return;
+			}
+			for (uint64_t i = 0; i < size; ++i) {
+				uint64_t value = form[i] > 0 ? (uint64_t)form[i] & mask : 0;
+				if (bits == 4) data[i >> 1] |= (char)(value << ((i & 1) * 4));
+				else putNumber(data + i * (bits / 8), value, bits / 8);
+			}
+		}
+
+		// unpack one sudoku, the empty form is cleared if marked
+		void unpackForm(const char* data, uint64_t size, uint8_t bits, bool marked, std::vector<FastSudoku::save_t>& form)
+		{
+			form.resize((size_t)size);
+			for (uint64_t i = 0; i < size; ++i) {
+				if (bits == 4) form[i] = ((unsigned char)data[i >> 1] >> ((i & 1) * 4)) & 0xF;
+				else form[i] = (FastSudoku::save_t)getNumber(data + i * (bits / 8), bits / 8);
+			}
+			if (marked && size > 0 && (uint64_t)form[0] == (1ull << bits) - 1) form.clear();
+		}
+	}
+
+	/// <summary>
+	/// create a corpus file
+	/// </summary>
+	/// <param name="path">path of file</param>
+	/// <param name="blockSize">count of sudokus in one block</param>
+	/// <param name="compress">if compress the blocks</param>
+	CorpusWriter::CorpusWriter(const std::string& path, index_t blockSize, bool compress)
+		: blockSize(blockSize ? blockSize : 1), compress(compress)
+	{
+		file = fopen(path.c_str(), "wb");
+		if (!file) return;
+
+		// the header is written when closing, the zeros keep the unfinished file not a corpus
+		char header[Corpus::headerSize] = {};
+		fwrite(header, 1, sizeof(header), file);
+		offset = Corpus::headerSize;
+	}
+
+	/// <summary>
+	/// finish the corpus
+	/// </summary>
+	CorpusWriter::~CorpusWriter()
+	{
+		close();
+	}
+
+	/// <summary>
+	/// judge if the file is opened
+	/// </summary>
+	/// <returns>if is opened</returns>
+	bool CorpusWriter::isOpen() const
+	{
+		return file != nullptr;
+	}
+
+	/// <summary>
+	/// write one sudoku, the length of corpus is decided by the first not empty form,
+	/// the empty form or the form of different length is written as an empty form
+	/// </summary>
+	/// <param name="form">the form</param>
+	/// <returns>CorpusWriter</returns>
+	CorpusWriter& CorpusWriter::write(const std::vector<save_t>& form)
+	{
+		if (!file) return *this;
+
+		// keep the empty forms before the size is known
+		if (formSize == 0) {
+			if (form.empty()) {
+				++pendingCount;
+				return *this;
+			}
+			formSize = (index_t)form.size();
+			cellBits = getCellBits(formSize);
+			for (; pendingCount; --pendingCount) append(nullptr);
+		}
+
+		append(form.size() == formSize ? form.data() : nullptr);
+		return *this;
+	}
+
+	/// <summary>
+	/// append one packed sudoku to the block
+	/// </summary>
+	/// <param name="form">the cells, null for an empty form</param>
+	void CorpusWriter::append(const save_t* form)
+	{
+		packForm(form, formSize, cellBits, block);
+		++count;
+		if (++blockCount >= blockSize) flushBlock();
+	}
+
+	/// <summary>
+	/// write the block into file
+	/// </summary>
+	void CorpusWriter::flushBlock()
+	{
+		if (blockCount == 0) return;
+
+		// store the raw block if compression doesn't help
+		const std::string* data = &block;
+		if (compress) {
+			compressZeroRun(block, stored);
+			if (stored.size() < block.size()) data = &stored;
+		}
+		fwrite(data->data(), 1, data->size(), file);
+
+		BlockIndex index;
+		index.offset = offset;
+		index.storedSize = (uint32_t)data->size();
+		index.count = blockCount;
+		blocks.push_back(index);
+		offset += data->size();
+
+		block.clear();
+		blockCount = 0;
+	}
+
+	/// <summary>
+	/// write the header of the corpus
+	/// </summary>
+	void CorpusWriter::writeHeader()
+	{
+		index_t dim = (index_t)std::lround(std::sqrt(std::sqrt((double)formSize)));
+		if (dim * dim * dim * dim != formSize) dim = 0;
+
+		char header[Corpus::headerSize] = {};
+		memcpy(header, Corpus::magic, sizeof(Corpus::magic));
+		putNumber(header + 8, Corpus::version, 2);
+		putNumber(header + 10, dim, 2);
+		putNumber(header + 12, formSize, 4);
+		putNumber(header + 16, count, 8);
+		putNumber(header + 24, blockSize, 4);
+		header[28] = (char)cellBits;
+		header[29] = (char)(compress ? Corpus::compressionZeroRun : Corpus::compressionNone);
+		putNumber(header + 32, blocks.size(), 4);
+		putNumber(header + 40, offset, 8);
+
+		fseek(file, 0, SEEK_SET);
+		fwrite(header, 1, sizeof(header), file);
+	}
+
+	/// <summary>
+	/// write the last block, the index and the header, then close the file
+	/// </summary>
+	/// <returns>if write successfully</returns>
+	bool CorpusWriter::close()
+	{
+		if (!file) return false;
+
+		for (; pendingCount; --pendingCount) append(nullptr);
+		flushBlock();
+
+		// the index after all blocks
+		std::string index(blocks.size() * Corpus::indexItemSize, '\0');
+		for (size_t i = 0; i < blocks.size(); ++i) {
+			char* item = &index[i * Corpus::indexItemSize];
+			putNumber(item, blocks[i].offset, 8);
+			putNumber(item + 8, blocks[i].storedSize, 4);
+			putNumber(item + 12, blocks[i].count, 4);
+		}
+		fwrite(index.data(), 1, index.size(), file);
+		writeHeader();
+
+		bool ok = !ferror(file);
+		ok = fclose(file) == 0 && ok;
+		file = nullptr;
+		return ok;
+	}
+
+	/// <summary>
+	/// get the count of sudokus written
+	/// </summary>
+	/// <returns>count</returns>
+	uint64_t CorpusWriter::getCount() const
+	{
+		return count + pendingCount;
+	}
+
+	/// <summary>
+	/// open a corpus file
+	/// </summary>
+	/// <param name="path">path of file</param>
+	CorpusReader::CorpusReader(const std::string& path)
+	{
+		open(path);
+	}
+
+	/// <summary>
+	/// open a corpus file, and check the header and index
+	/// </summary>
+	/// <param name="path">path of file</param>
+	/// <returns>if is a good corpus</returns>
+	bool CorpusReader::open(const std::string& path)
+	{
+		data = std::string_view();
+		if (!file.open(path)) return false;
+
+		std::string_view view = file.view();
+		if (view.size() < Corpus::headerSize || memcmp(view.data(), Corpus::magic, sizeof(Corpus::magic)) != 0) return false;
+		const char* header = view.data();
+		version = (uint16_t)getNumber(header + 8, 2);
+		if (version > Corpus::version) return false;
+
+		formDim = (index_t)getNumber(header + 10, 2);
+		formSize = (index_t)getNumber(header + 12, 4);
+		count = getNumber(header + 16, 8);
+		blockSize = (index_t)getNumber(header + 24, 4);
+		cellBits = (uint8_t)header[28];
+		compression = (uint8_t)header[29];
+		blockCount = (index_t)getNumber(header + 32, 4);
+		indexOffset = getNumber(header + 40, 8);
+
+		if ((cellBits != 4 && cellBits != 8 && cellBits != 16) || compression > Corpus::compressionZeroRun) return false;
+		if (indexOffset < Corpus::headerSize || indexOffset > view.size()
+			|| (view.size() - indexOffset) / Corpus::indexItemSize < blockCount) return false;
+
+		data = view;
+		return true;
+	}
+
+	/// <summary>
+	/// judge if the corpus is opened
+	/// </summary>
+	/// <returns>if is opened</returns>
+	bool CorpusReader::isOpen() const
+	{
+		return !data.empty();
+	}
+
+	/// <summary>
+	/// judge if the file is a corpus by the magic
+	/// </summary>
+	/// <param name="path">path of file, stdin ("-") is not checked</param>
+	/// <returns>if is a corpus</returns>
+	bool CorpusReader::isCorpus(const std::string& path)
+	{
+		if (path == "-") return false;
+		FILE* in = fopen(path.c_str(), "rb");
+		if (!in) return false;
+		char magic[sizeof(Corpus::magic)];
+		bool result = fread(magic, 1, sizeof(magic), in) == sizeof(magic) && memcmp(magic, Corpus::magic, sizeof(magic)) == 0;
+		fclose(in);
+		return result;
+	}
+
+	/// <summary>
+	/// read all sudokus of one block
+	/// </summary>
+	/// <param name="block">index of block</param>
+	/// <param name="forms">the forms read</param>
+	/// <returns>if read successfully</returns>
+	bool CorpusReader::readBlock(index_t block, std::vector<std::vector<save_t>>& forms) const
+	{
+		forms.clear();
+		if (block >= blockCount) return false;
+
+		const char* item = data.data() + indexOffset + (size_t)block * Corpus::indexItemSize;
+		uint64_t offset = getNumber(item, 8);
+		uint64_t storedSize = getNumber(item + 8, 4);
+		index_t itemCount = (index_t)getNumber(item + 12, 4);
+		if (offset < Corpus::headerSize || offset > indexOffset || storedSize > indexOffset - offset) return false;
+
+		// the count is not more than a block and the sudokus left, and the raw block can be made of the bytes stored
+		// (a byte of zero run is 128 bytes at most), so a bad index can't make a huge block
+		const uint64_t packedSize = getPackedSize(formSize, cellBits);
+		const uint64_t rawLimit = compression == Corpus::compressionZeroRun ? storedSize * 128 : storedSize;
+		if (itemCount > blockSize || itemCount > count - std::min<uint64_t>(count, (uint64_t)block * blockSize)
+			|| (packedSize > 0 && itemCount > rawLimit / packedSize)) return false;
+
+		const size_t rawSize = (size_t)(packedSize * itemCount);
+		std::string_view stored = data.substr((size_t)offset, (size_t)storedSize);
+		std::string raw;
+		if (storedSize != rawSize) {
+			if (compression != Corpus::compressionZeroRun || !decompressZeroRun(stored, raw, rawSize)) return false;
+			stored = raw;
+		}
+
+		forms.resize(itemCount);
+		for (index_t i = 0; i < itemCount; ++i) {
+			unpackForm(stored.data() + i * packedSize, formSize, cellBits, version >= 2, forms[i]);
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// read one sudoku by random access
+	/// </summary>
+	/// <param name="index">index of sudoku</param>
+	/// <param name="form">the form read</param>
+	/// <returns>if read successfully</returns>
+	bool CorpusReader::read(uint64_t index, std::vector<save_t>& form) const
+	{
+		form.clear();
+		if (index >= count || blockSize == 0) return false;
+
+		// all blocks are full except the last one
+		std::vector<std::vector<save_t>> forms;
+		if (!readBlock((index_t)(index / blockSize), forms) || index % blockSize >= forms.size()) return false;
+		form = std::move(forms[index % blockSize]);
+		return true;
+	}
+
+	/// <summary>
+	/// get the blocks of one shard, so the threads can read their own shards in parallel
+	/// </summary>
+	/// <param name="shard">index of shard</param>
+	/// <param name="shards">count of shards</param>
+	/// <returns>blocks [first, second)</returns>
+	std::pair<CorpusReader::index_t, CorpusReader::index_t> CorpusReader::shardBlocks(index_t shard, index_t shards) const
+	{
+		if (shards == 0 || shard >= shards) return { 0, 0 };
+		return { (index_t)((uint64_t)blockCount * shard / shards), (index_t)((uint64_t)blockCount * (shard + 1) / shards) };
+	}
+
+	/// <summary>
+	/// get the dimension of form, 0 if the form is not a normal sudoku
+	/// </summary>
+	/// <returns>dimension</returns>
+	CorpusReader::index_t CorpusReader::getFormDimension() const
+	{
+		return formDim;
+	}
+
+	/// <summary>
+	/// get the count of cells of form
+	/// </summary>
+	/// <returns>size</returns>
+	CorpusReader::index_t CorpusReader::getFormSize() const
+	{
+		return formSize;
+	}
+
+	/// <summary>
+	/// get the count of sudokus
+	/// </summary>
+	/// <returns>count</returns>
+	uint64_t CorpusReader::getCount() const
+	{
+		return count;
+	}
+
+	/// <summary>
+	/// get the count of blocks
+	/// </summary>
+	/// <returns>count</returns>
+	CorpusReader::index_t CorpusReader::getBlockCount() const
+	{
+		return blockCount;
+	}
+
+	/// <summary>
+	/// get the count of sudokus in one full block
+	/// </summary>
+	/// <returns>count</returns>
+	CorpusReader::index_t CorpusReader::getBlockSize() const
+	{
+		return blockSize;
+	}
+}
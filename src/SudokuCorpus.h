@@ -0,0 +1,112 @@
+﻿// Code By YYYCZ
+
+#ifndef __YYYCZ_SUDOKU_CORPUS_H__
+#define __YYYCZ_SUDOKU_CORPUS_H__
+
+#include "FastSudoku.h"
+#include "SudokuIO.h"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace YYYCZ {
+	// the binary corpus of sudokus:
+	// header (64 bytes) | blocks | index (offset, stored size, count of every block).
+	// the cells are packed by 4 bits (9*9 is 41 bytes), or 8 / 16 bits for bigger forms,
+	// every block can be compressed by run-length of zero bytes.
+	// an empty form (no solution) has all bits set in its first cell, so it isn't read as a blank sudoku (since version 2).
+	// all numbers are little endian.
+	namespace Corpus {
+		constexpr char magic[8] = { 'Y', 'S', 'D', 'K', 'C', 'O', 'R', 'P' };
+		constexpr uint16_t version = 2;
+		constexpr size_t headerSize = 64;
+		constexpr size_t indexItemSize = 16;
+		constexpr uint8_t compressionNone = 0;
+		constexpr uint8_t compressionZeroRun = 1;
+	}
+
+	// write the sudokus into a binary corpus
+	class CorpusWriter {
+	public:
+		using save_t = FastSudoku::save_t;
+		using index_t = FastSudoku::index_t;
+
+	private:
+		// the index of one block
+		struct BlockIndex {
+			uint64_t offset = 0;
+			uint32_t storedSize = 0;
+			uint32_t count = 0;
+		};
+
+		FILE* file = nullptr; // the file
+		index_t formSize = 0; // the count of cells of form, 0 before the first sudoku
+		index_t blockSize = 4096; // count of sudokus in one block
+		bool compress = true; // if compress the blocks
+		uint8_t cellBits = 4; // bits of one cell
+		uint64_t count = 0; // count of sudokus
+		uint64_t offset = 0; // the offset to write
+		std::vector<BlockIndex> blocks; // index of blocks
+		std::string block; // the packed block
+		std::string stored; // the compressed block
+		index_t blockCount = 0; // count of sudokus in now block
+		uint64_t pendingCount = 0; // count of empty forms before the length is known
+
+		void append(const save_t* form);
+		void flushBlock();
+		void writeHeader();
+
+	public:
+		CorpusWriter(const std::string& path, index_t blockSize = 4096, bool compress = true);
+		CorpusWriter(const CorpusWriter&) = delete;
+		CorpusWriter& operator=(const CorpusWriter&) = delete;
+		~CorpusWriter();
+
+		bool isOpen() const;
+		CorpusWriter& write(const std::vector<save_t>& form); // empty or different size writes an empty form
+		bool close(); // write the index and header
+		uint64_t getCount() const;
+	};
+
+	// read the sudokus from a binary corpus.
+	// the file is mapped, and reading is const, so many threads can read
+	// different blocks of one reader at the same time
+	class CorpusReader {
+	public:
+		using save_t = FastSudoku::save_t;
+		using index_t = FastSudoku::index_t;
+
+	private:
+		MappedFile file; // the mapped file
+		std::string_view data; // the content of file
+		uint16_t version = 0; // the version of file
+		index_t formDim = 0; // the dimension of form
+		index_t formSize = 0; // the count of cells of form
+		uint8_t cellBits = 4; // bits of one cell
+		uint8_t compression = 0; // the compression of blocks
+		index_t blockSize = 0; // count of sudokus in one full block
+		uint64_t count = 0; // count of sudokus
+		index_t blockCount = 0; // count of blocks
+		uint64_t indexOffset = 0; // offset of index
+
+	public:
+		CorpusReader() = default;
+		CorpusReader(const std::string& path);
+
+		bool open(const std::string& path);
+		bool isOpen() const;
+		static bool isCorpus(const std::string& path); // judge if the file is a corpus by the magic
+
+		bool readBlock(index_t block, std::vector<std::vector<save_t>>& forms) const; // read all sudokus of one block
+		bool read(uint64_t index, std::vector<save_t>& form) const; // read one sudoku by random access
+		std::pair<index_t, index_t> shardBlocks(index_t shard, index_t shards) const; // blocks [first, second) of one shard
+
+		index_t getFormDimension() const;
+		index_t getFormSize() const;
+		uint64_t getCount() const;
+		index_t getBlockCount() const;
+		index_t getBlockSize() const;
+	};
+}
+
+#endif
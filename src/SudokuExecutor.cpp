@@ -0,0 +1,223 @@
+﻿// Code By YYYCZ
+
+#include "SudokuExecutor.h"
+
+namespace YYYCZ {
+	// the settings of the shared executor
+	static std::mutex sharedMutex;
+	static std::unique_ptr<SudokuExecutor> sharedExecutor;
+	static SudokuExecutor::index_t sharedThreadCount = 0;
+	static SolutionCache* sharedCache = nullptr;
+
+	/// <summary>
+	/// create the executor and start the threads
+	/// </summary>
+	/// <param name="threadCount">count of threads, 0 for hardware concurrency</param>
+	/// <param name="cache">the cache shared by the solvers, null if not use</param>
+	SudokuExecutor::SudokuExecutor(index_t threadCount, SolutionCache* cache)
+		: solutionCache(cache)
+	{
+		if (threadCount == 0) threadCount = std::thread::hardware_concurrency();
+		if (threadCount == 0) threadCount = 1;
+		for (index_t i = 0; i < threadCount; ++i) {
+			threads.emplace_back(&SudokuExecutor::work, this);
+		}
+	}
+
+	/// <summary>
+	/// solve the tasks waiting, then join the threads
+	/// </summary>
+	SudokuExecutor::~SudokuExecutor()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		ready.notify_all();
+		for (auto& thread : threads) thread.join();
+	}
+
+	/// <summary>
+	/// the worker, take the tasks and solve them by its own solver
+	/// </summary>
+	void SudokuExecutor::work()
+	{
+		FastSudoku solver;
+		solver.setSolutionCache(solutionCache);
+
+		while (true) {
+			Task task;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				ready.wait(lock, [this]() { return stopping || !tasks.empty(); });
+				if (tasks.empty()) return;
+				task = std::move(tasks.front());
+				tasks.pop_front();
+			}
+			task.callback(solver.solve(task.form, task.options));
+		}
+	}
+
+	/// <summary>
+	/// solve the sudoku asynchronously
+	/// </summary>
+	/// <param name="form">the sudoku form</param>
+	/// <param name="options">the options</param>
+	/// <returns>the future of result</returns>
+	std::future<SudokuExecutor::SolveResult> SudokuExecutor::solveAsync(std::vector<save_t> form, const SolveOptions& options)
+	{
+		auto promise = std::make_shared<std::promise<SolveResult>>();
+		auto future = promise->get_future();
+		solveAsync(std::move(form), options, [promise](SolveResult&& result) {
+			promise->set_value(std::move(result));
+		});
+		return future;
+	}
+
+	/// <summary>
+	/// solve the sudoku asynchronously, and call back on the thread solving it
+	/// </summary>
+	/// <param name="form">the sudoku form</param>
+	/// <param name="options">the options</param>
+	/// <param name="callback">called with the result</param>
+	void SudokuExecutor::solveAsync(std::vector<save_t> form, const SolveOptions& options, Callback callback)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			tasks.push_back({ std::move(form), options, std::move(callback) });
+		}
+		ready.notify_one();
+	}
+
+	/// <summary>
+	/// race the configurations on the threads, the first definite result is given
+	/// </summary>
+	/// <param name="form">the sudoku form</param>
+	/// <param name="configs">the configurations</param>
+	/// <returns>the future of result</returns>
+	std::future<SudokuExecutor::SolveResult> SudokuExecutor::solvePortfolio(std::vector<save_t> form, const std::vector<SolveOptions>& configs)
+	{
+		auto promise = std::make_shared<std::promise<SolveResult>>();
+		auto future = promise->get_future();
+		solvePortfolio(std::move(form), configs, [promise](SolveResult&& result) {
+			promise->set_value(std::move(result));
+		});
+		return future;
+	}
+
+	/// <summary>
+	/// race the configurations on the threads, and call back with the first definite result.
+	/// the others are cancelled by a shared token
+	/// </summary>
+	/// <param name="form">the sudoku form</param>
+	/// <param name="configs">the configurations</param>
+	/// <param name="callback">called once with the result</param>
+	void SudokuExecutor::solvePortfolio(std::vector<save_t> form, const std::vector<SolveOptions>& configs, Callback callback)
+	{
+		if (configs.empty()) {
+			solveAsync(std::move(form), SolveOptions(), std::move(callback));
+			return;
+		}
+
+		// the state of the race
+		struct Race {
+			std::atomic<bool> cancel{ false }; // set by the winner
+			std::atomic<index_t> running{ 0 }; // count of configurations not finished
+			Callback callback;
+		};
+		auto race = std::make_shared<Race>();
+		race->running = (index_t)configs.size();
+		race->callback = std::move(callback);
+
+		for (size_t i = 0; i < configs.size(); ++i) {
+			SolveOptions options = configs[i];
+			options.cancelToken = &race->cancel;
+			solveAsync(i + 1 == configs.size() ? std::move(form) : form, options, [race](SolveResult&& result) {
+				const bool definite = result.status == SolveResult::Status_Solved
+					|| result.status == SolveResult::Status_NoSolution || result.status == SolveResult::Status_Invalid;
+				const bool last = --race->running == 0;
+				if (definite && !race->cancel.exchange(true)) {
+					race->callback(std::move(result));
+				}
+				else if (last && !race->cancel.exchange(true)) {
+					race->callback(std::move(result));
+				}
+			});
+		}
+	}
+
+	/// <summary>
+	/// make the configurations of different searches from the options,
+	/// the order of numbers, the place chosen and the propagation are different
+	/// </summary>
+	/// <param name="options">the options, such as limits</param>
+	/// <param name="count">count of configurations</param>
+	/// <returns>configurations</returns>
+	std::vector<SudokuExecutor::SolveOptions> SudokuExecutor::makePortfolio(const SolveOptions& options, index_t count)
+	{
+		static const char settings[][3] = {
+			{ FastSudoku::ValueOrder_Default, FastSudoku::TieBreak_Default, FastSudoku::Propagation_NakedSingles },
+			{ FastSudoku::ValueOrder_Ascending, FastSudoku::TieBreak_LowestIndex, FastSudoku::Propagation_HiddenSingles },
+			{ FastSudoku::ValueOrder_Descending, FastSudoku::TieBreak_HighestIndex, FastSudoku::Propagation_NakedSingles },
+			{ FastSudoku::ValueOrder_Descending, FastSudoku::TieBreak_LowestIndex, FastSudoku::Propagation_HiddenSingles },
+			{ FastSudoku::ValueOrder_Ascending, FastSudoku::TieBreak_HighestIndex, FastSudoku::Propagation_NakedSingles },
+			{ FastSudoku::ValueOrder_Default, FastSudoku::TieBreak_HighestIndex, FastSudoku::Propagation_HiddenSingles },
+		};
+		const index_t settingCount = sizeof(settings) / sizeof(settings[0]);
+
+		std::vector<SolveOptions> configs;
+		for (index_t i = 0; i < count && i < settingCount; ++i) {
+			SolveOptions config = options;
+			config.valueOrder = settings[i][0];
+			config.tieBreak = settings[i][1];
+			config.propagation = settings[i][2];
+			configs.push_back(config);
+		}
+		return configs;
+	}
+
+	/// <summary>
+	/// get the count of threads
+	/// </summary>
+	/// <returns>count</returns>
+	SudokuExecutor::index_t SudokuExecutor::getThreadCount() const
+	{
+		return (index_t)threads.size();
+	}
+
+	/// <summary>
+	/// get the count of tasks waiting
+	/// </summary>
+	/// <returns>count</returns>
+	size_t SudokuExecutor::getPendingCount() const
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return tasks.size();
+	}
+
+	/// <summary>
+	/// get the executor shared by the program, it is created when first used
+	/// </summary>
+	/// <returns>the shared executor</returns>
+	SudokuExecutor& SudokuExecutor::shared()
+	{
+		std::lock_guard<std::mutex> lock(sharedMutex);
+		if (!sharedExecutor) sharedExecutor.reset(new SudokuExecutor(sharedThreadCount, sharedCache));
+		return *sharedExecutor;
+	}
+
+	/// <summary>
+	/// set the shared executor, only before it is used
+	/// </summary>
+	/// <param name="threadCount">count of threads, 0 for hardware concurrency</param>
+	/// <param name="cache">the cache shared by the solvers, null if not use</param>
+	/// <returns>false if the shared executor is created</returns>
+	bool SudokuExecutor::configureShared(index_t threadCount, SolutionCache* cache)
+	{
+		std::lock_guard<std::mutex> lock(sharedMutex);
+		if (sharedExecutor) return false;
+		sharedThreadCount = threadCount;
+		sharedCache = cache;
+		return true;
+	}
+}
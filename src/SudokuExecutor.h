@@ -0,0 +1,106 @@
+﻿// Code By YYYCZ
+
+#ifndef __YYYCZ_SUDOKU_EXECUTOR_H__
+#define __YYYCZ_SUDOKU_EXECUTOR_H__
+
+#include "FastSudoku.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#define __YYYCZ_SUDOKU_COROUTINE__
+#endif
+
+namespace YYYCZ {
+	class SolutionCache;
+
+	// solve the sudokus asynchronously by a pool of threads,
+	// every thread keeps its own solver, so no solver is shared or created for a task.
+	// the callback runs on the thread solving it, no more thread to hop.
+	// the time limit of options begins when the solving begins, the deadline includes the waiting.
+	// THREAD SAFE
+	class SudokuExecutor {
+	public:
+		using save_t = FastSudoku::save_t;
+		using index_t = FastSudoku::index_t;
+		using SolveResult = FastSudoku::SolveResult;
+		using SolveOptions = FastSudoku::SolveOptions;
+		using Callback = std::function<void(SolveResult&&)>;
+
+	private:
+		// a sudoku to solve
+		struct Task {
+			std::vector<save_t> form;
+			SolveOptions options;
+			Callback callback;
+		};
+
+		std::vector<std::thread> threads; // the workers
+		std::deque<Task> tasks; // the tasks waiting
+		mutable std::mutex mutex; // lock of tasks
+		std::condition_variable ready; // notify the workers
+		bool stopping = false; // if no more task
+		SolutionCache* solutionCache = nullptr; // the cache shared by the solvers, null if not use
+
+		void work();
+
+	public:
+		SudokuExecutor(index_t threadCount = 0, SolutionCache* cache = nullptr); // 0 for hardware concurrency
+		~SudokuExecutor(); // solve the tasks waiting, then join the threads
+		SudokuExecutor(const SudokuExecutor&) = delete;
+		SudokuExecutor& operator=(const SudokuExecutor&) = delete;
+
+		std::future<SolveResult> solveAsync(std::vector<save_t> form, const SolveOptions& options = SolveOptions());
+		void solveAsync(std::vector<save_t> form, const SolveOptions& options, Callback callback);
+
+		// race the configurations, the first result solved (or proved no solution) wins and the rest are cancelled.
+		// the cancel tokens of configurations are replaced, if none wins the result of the last is given
+		std::future<SolveResult> solvePortfolio(std::vector<save_t> form, const std::vector<SolveOptions>& configs);
+		void solvePortfolio(std::vector<save_t> form, const std::vector<SolveOptions>& configs, Callback callback);
+		static std::vector<SolveOptions> makePortfolio(const SolveOptions& options, index_t count = 4); // different searches from the options
+
+		index_t getThreadCount() const;
+		size_t getPendingCount() const;
+
+		static SudokuExecutor& shared(); // the executor shared by the program, created when first used
+		static bool configureShared(index_t threadCount, SolutionCache* cache = nullptr); // false if the shared one is created
+
+#ifdef __YYYCZ_SUDOKU_COROUTINE__
+		// co_await executor.solveAwait(form) in a coroutine, it resumes on the thread solving it
+		class SolveAwaiter {
+			SudokuExecutor& executor;
+			std::vector<save_t> form;
+			SolveOptions options;
+			SolveResult result;
+
+		public:
+			SolveAwaiter(SudokuExecutor& executor, std::vector<save_t> form, const SolveOptions& options)
+				: executor(executor), form(std::move(form)), options(options) {}
+
+			bool await_ready() const noexcept { return false; }
+			void await_suspend(std::coroutine_handle<> handle)
+			{
+				executor.solveAsync(std::move(form), options, [this, handle](SolveResult&& solved) {
+					result = std::move(solved);
+					handle.resume();
+				});
+			}
+			SolveResult await_resume() { return std::move(result); }
+		};
+
+		SolveAwaiter solveAwait(std::vector<save_t> form, const SolveOptions& options = SolveOptions())
+		{
+			return SolveAwaiter(*this, std::move(form), options);
+		}
+#endif
+	};
+}
+
+#endif
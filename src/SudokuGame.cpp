@@ -2,82 +2,84 @@
 
 #include "SudokuGame.h"
 #include "SudokuHeader.h"
+#include "SudokuIO.h"
 #include <iostream>
 #include <iomanip>
 
 namespace YYYCZ {
-	void SudokuGame::printTime()
+	void SudokuGame::printTime(std::ostream& out)
 	{
 		if (solver.getTimingMode() == solver.TimingMode_TimingNow) {
 			solver.setTimingMode(solver.TimingMode_TimingNow);
 		}
-		std::cout << "Timing: \033[031m"
+		out << "Timing: \033[031m"
 			<< std::fixed << std::setprecision(3) << solver.getDuration()
 			<< "\033[0m s.\n";
 	}
 
-	void SudokuGame::printForm()
+	void SudokuGame::printForm(std::ostream& out)
 	{
-		solver.printForm(row, column);
+		solver.printForm(out, row, column);
 	}
 
-	void SudokuGame::printFill()
+	void SudokuGame::printFill(std::ostream& out)
 	{
-		std::cout << "\033[32mLegal Numbers\033[0m\n  ";
-		auto legalNumbers = solver.getLegalNumbersAt(row, column);
+		out << "\033[32mLegal Numbers\033[0m\n  ";
+		auto legalNumbers = solver.getLegalMaskAt(row, column);
 		for (save_t i = 1; i <= solver.getFormLength(); ++i) {
-			if (legalNumbers.count(i) == 0) {
-				std::cout << "\033[30m\033[1m" << i;
+			if (((legalNumbers >> i) & 1) == 0) {
+				out << "\033[30m\033[1m" << i;
 			}
 			else {
-				std::cout << "\033[33m\033[1m" << i;
+				out << "\033[33m\033[1m" << i;
 			}
 			if (i != solver.getFormLength()) {
-				std::cout << "\033[0m, ";
+				out << "\033[0m, ";
 			}
 		}
-		std::cout << "\n\n"
+		out << "\n\n"
 			"\033[033mTip\033[0m: 1. Press \033[033mL\033[0m again to back to main UI;\n"
 			"     2. \033[33m\033[1mHighlight\033[0m numbers is legal;\n"
-			"     3. \033[30m\033[1mOther\033[0m numbers is illegal."
-			<< std::endl;
+			"     3. \033[30m\033[1mOther\033[0m numbers is illegal.\n";
 	}
 
-	void SudokuGame::printHelp()
+	void SudokuGame::printHelp(std::ostream& out)
 	{
 		static const char* helpMsg =
 			"\033[032mGame Help\033[0m\n"
 			"  1. Press \033[033mUp\033[0m, \033[033mDown\033[0m, \033[033mLeft\033[0m, \033[033mRight\033[0m to move cursor;\n"
 			"  2. Press \033[033mNumber\033[0m to fill a number into this place;\n"
 			"  3. Press \033[033mL\033[0m to see which numbers can be filled in this place;\n"
-			"  4. Press \033[033mU\033[0m to undo;\n"
+			"  4. Press \033[033mU\033[0m to undo, \033[033mY\033[0m to redo;\n"
 			"  5. Press \033[033mE\033[0m to erase number in this place;\n"
 			"  6. Press \033[033mR\033[0m to restart;\n"
-			"  7. Press \033[033mH\033[0m to see the suggest to fill number;\n"
-			"  8. Press \033[033mA\033[0m to see answer;\n"
-			"  9. Press \033[033mEsc\033[0m to exit;\n"
-			"  10. If the console draw incorrectly, please enlarge the window and press \033[33mL\033[0m twice.";
-		std::cout << helpMsg << std::endl;
+			"  7. Press \033[033mC\033[0m to save a checkpoint, \033[033mB\033[0m to back to it;\n"
+			"  8. Press \033[033mH\033[0m to see the suggest to fill number;\n"
+			"  9. Press \033[033mA\033[0m to see answer;\n"
+			"  10. Press \033[033mEsc\033[0m to exit;\n"
+			"  11. If the console draw incorrectly, please enlarge the window and press \033[33mL\033[0m twice.";
+		out << helpMsg << '\n';
 	}
 
-	void SudokuGame::printResult()
+	void SudokuGame::printResult(std::ostream& out)
 	{
-		result.printForm();
+		const auto view = solver.getView();
+		FastSudoku::printForm(out, result.solution, &view);
 	}
 
-	void SudokuGame::printTip()
+	void SudokuGame::printTip(std::ostream& out)
 	{
 		auto t = solver.tip();
-		std::cout << "\033[032mSuggest\033[0m\n";
+		out << "\033[032mSuggest\033[0m\n";
 		if (t.first != -1) {
-			std::cout << "  Fill \033[033m" << t.first << "\033[0m into row \033[033m" << t.second.first + 1
-				<< "\033[0m column \033[033m" << t.second.second + 1 << "\033[0m" << std::endl;
+			out << "  Fill \033[033m" << t.first << "\033[0m into row \033[033m" << t.second.first + 1
+				<< "\033[0m column \033[033m" << t.second.second + 1 << "\033[0m\n";
 		}
 		else {
-			std::cout << "  \033[031mTry to erase number!\033[0m                " << std::endl;
+			out << "  \033[031mTry to erase number!\033[0m                \n";
 		}
-		std::cout << "\n"
-			"\033[033mTip\033[0m: Press \033[033mH\033[0m again to back to main UI.\n" << std::endl;
+		out << "\n"
+			"\033[033mTip\033[0m: Press \033[033mH\033[0m again to back to main UI.\n\n";
 	}
 
 	/// <summary>
@@ -89,7 +91,7 @@ namespace YYYCZ {
 		if (newState >= 0 && newState < screens.size()) {
 			*const_cast<int*>(&this->state) = newState;
 		}
-		clearConsole();
+		renderer.invalidate();
 	}
 
 	/// <summary>
@@ -97,21 +99,22 @@ namespace YYYCZ {
 	/// </summary>
 	void SudokuGame::draw()
 	{
-		// relocate cursor in the console
-		relocateConsole();
-
-		// draw the screen
+		// draw the screen into the frame
+		std::ostream& out = renderer.beginFrame();
 		for (auto& p : this->screens[state]) {
 			if (p.isFunction) {
 				auto itr = this->printFunctions.find(p.content);
 				if (itr != this->printFunctions.end()) {
-					itr->second();
+					itr->second(out);
 				}
 			}
 			else {
-				std::cout << p.content;
+				out << p.content;
 			}
 		}
+
+		// only write the changes to the console
+		renderer.endFrame();
 	}
 
 	/// <summary>
@@ -157,60 +160,94 @@ namespace YYYCZ {
 	/// </summary>
 	void SudokuGame::mainThread()
 	{
+		// keep the console raw during the game, and only wake up when some keys be pressed,
+		// or redraw the clock when timing
+		ConsoleSession session;
 		int key;
 		while (true) {
-			if (isKeyPressed()) {
-				key = getKeyPressed();
+			// update console
+			draw();
 
-				if (state == stateFinish) {
-					break;
-				}
+			const bool timing = solver.getTimingMode() == solver.TimingMode_TimingNow;
+			if (!waitKeyPressed(timing ? duration : -1)) {
+				continue;
+			}
+			key = getKeyPressed();
 
-				// direction control
-				int direction = judgeDirection(key);
-				if(direction != -1){
-					move(direction);
-				}
-				// fill number
-				else if (key >= '1' && key <= '9') {
-					fillNumber(key - '0');
-				}
-				// see legal
-				else if (key == 'L' || key == 'l') {
-					setState(state == stateFill ? stateHelp : stateFill);
-				}
-				// undo
-				else if (key == 'U' || key == 'u') {
-					solver.undo();
-				}
-				// erase
-				else if (key == 'E' || key == 'e' || key == '0') {
-					solver.erase(row, column);
-				}
-				// restart
-				else if (key == 'R' || key == 'r') {
-					solver.restart();
-				}
-				// tip
-				else if (key == 'H' || key == 'h') {
-					setState(state == stateTip ? stateHelp : stateTip);
-				}
-				// answer
-				else if (key == 'A' || key == 'a') {
-					setState(state == stateResult ? stateHelp : stateResult);
-				}
-				// esc
-				else if (key == 27) {
-					break;
-				}
+			// input closed
+			if (key == -1) {
+				break;
+			}
+
+			if (state == stateFinish) {
+				break;
+			}
+
+			// direction control
+			int direction = judgeDirection(key);
+			if(direction != -1){
+				move(direction);
+			}
+			// fill number
+			else if (key >= '1' && key <= '9') {
+				fillNumber(key - '0');
+			}
+			// see legal
+			else if (key == 'L' || key == 'l') {
+				setState(state == stateFill ? stateHelp : stateFill);
+			}
+			// undo
+			else if (key == 'U' || key == 'u') {
+				solver.undo();
+			}
+			// redo
+			else if (key == 'Y' || key == 'y') {
+				solver.redo();
+			}
+			// erase
+			else if (key == 'E' || key == 'e' || key == '0') {
+				solver.erase(row, column);
+			}
+			// restart
+			else if (key == 'R' || key == 'r') {
+				solver.restart();
+			}
+			// checkpoint
+			else if (key == 'C' || key == 'c') {
+				solver.setCheckpoint("game");
+			}
+			// back to checkpoint
+			else if (key == 'B' || key == 'b') {
+				solver.checkout("game");
+			}
+			// tip
+			else if (key == 'H' || key == 'h') {
+				setState(state == stateTip ? stateHelp : stateTip);
+			}
+			// answer
+			else if (key == 'A' || key == 'a') {
+				setState(state == stateResult ? stateHelp : stateResult);
+			}
+			// esc
+			else if (key == 27) {
+				break;
 			}
-			// update console
-			draw();
-			// yield the thread
-			wait(duration);
 		}
 	}
 
+	/// <summary>
+	/// generate a form, the generator is dropped after it
+	/// </summary>
+	/// <param name="numberCount">the count of numbers</param>
+	/// <param name="dim">the dimension</param>
+	/// <returns>the form</returns>
+	std::vector<SudokuGame::save_t> SudokuGame::generateForm(index_t numberCount, save_t dim)
+	{
+		FastSudoku generator;
+		while (!generator.generate(numberCount, dim));
+		return generator.getResult();
+	}
+
 	/// <summary>
 	/// game start, have fun!
 	/// </summary>
@@ -228,9 +265,9 @@ namespace YYYCZ {
 		if (!solver.checkInit()) return;
 		solver.setMarkChange(false);
 
-		// get the result
-		result.solve(form);
-		if (result.getResult().empty()) return;
+		// get the result, the solver of it is dropped
+		result = FastSudoku().solve(form, FastSudoku::SolveOptions());
+		if (!result.isSolved()) return;
 
 		// hide cursor
 		setConsoleCursor(false);
@@ -249,7 +286,8 @@ namespace YYYCZ {
 	/// <summary>
 	/// game start, have fun!
 	/// </summary>
-	void SudokuGame::gameStart()
+	/// <returns>false if the input is closed</returns>
+	bool SudokuGame::gameStart()
 	{
 		clearConsole();
 		std::cout << "\033[0mWelcome to play \033[34mYYYCZ\033[0m's sudoku game!\n"
@@ -267,51 +305,44 @@ namespace YYYCZ {
 			"Note: If the console draw incorrectly, please enlarge the window and press \033[33mL\033[0m twice.\n";
 
 		while (true) {
-			if (isKeyPressed()) {
-				int key = getKeyPressed();
+			// wait for the key, no need to poll
+			int key = getKeyPressed();
+			if (key == -1) return false;
 
+			{
 				switch (key) {
 				case '1':
-					while (!result.generate(8, 2));
-					gameStart(result.getResult());
-					return;
+					gameStart(generateForm(8, 2));
+					return true;
 				case '2':
-					while (!result.generate(6, 2));
-					gameStart(result.getResult());
-					return;
+					gameStart(generateForm(6, 2));
+					return true;
 				case '3':
-					while (!result.generate(40));
-					gameStart(result.getResult());
-					return;
+					gameStart(generateForm(40));
+					return true;
 				case '4':
-					while (!result.generate(35));
-					gameStart(result.getResult());
-					return;
+					gameStart(generateForm(35));
+					return true;
 				case '5':
-					while (!result.generate(31));
-					gameStart(result.getResult());
-					return;
+					gameStart(generateForm(31));
+					return true;
 				case '6':
-					while (!result.generate(27));
-					gameStart(result.getResult());
-					return;
+					gameStart(generateForm(27));
+					return true;
 				case '7':
-					while (!result.generate(24));
-					gameStart(result.getResult());
-					return;
+					gameStart(generateForm(24));
+					return true;
 				case '8':
-					while (!result.generate(21));
-					gameStart(result.getResult());
-					return;
+					gameStart(generateForm(21));
+					return true;
 				case '9':
-					while (!result.generate(18));
-					gameStart(result.getResult());
-					return;
+					gameStart(generateForm(18));
+					return true;
 				case '0': {
 					std::vector<FastSudoku::save_t> sudoku;
 
 					clearConsole();
-					std::cout << "Please input the sudoku form. Use 0 to represent empty space, such as:\n\033[33m"
+					std::cout << "Please input the sudoku form. Use 0 or . to represent empty space, such as:\n\033[33m"
 						"7 4 0 6 3 0 0 0 0\n"
 						"0 0 0 0 0 0 0 0 0\n"
 						"0 0 5 2 0 0 0 3 0\n"
@@ -322,16 +353,31 @@ namespace YYYCZ {
 						"0 0 0 0 0 0 0 0 0\n"
 						"0 0 0 0 4 3 0 1 6\033[0m\n\n";
 
-					sudoku.resize(81, 0);
-					for (int i = 0; i < 81; ++i)
-						std::cin >> sudoku[i];
+					// read lines until get a sudoku, the numbers may be cut into lines in any way,
+					// so the lines are also joined into one line of numbers
+					std::string text, joined, line;
+					PuzzleReader reader;
+					auto read = [&](const std::string& input) {
+						return reader.reset(input).next(sudoku) && (sudoku.size() == 16 || sudoku.size() == 81);
+					};
+					while (std::getline(std::cin, line)) {
+						text += line;
+						text += '\n';
+						if (read(text)) break;
+
+						// the separator lines and the comments are not numbers
+						const size_t k = line.find_first_not_of(" \t\r-+|");
+						if (k == std::string::npos || line[k] == '#') continue;
+						joined += ' ';
+						joined += line;
+						if (read(joined)) break;
+					}
 
 					gameStart(sudoku);
-					return;
+					return true;
 				}
 				}
 			}
-			wait(duration);
 		}
 	}
 
@@ -4,6 +4,7 @@
 #define __YYYCZ_SUDOKU_GAME_H__
 
 #include "FastSudoku.h"
+#include "SudokuRenderer.h"
 #include <string>
 #include <unordered_map>
 
@@ -17,20 +18,20 @@ namespace YYYCZ {
 			std::string content;
 		};
 
-		void printTime();
-		void printForm();
-		void printFill();
-		void printHelp();
-		void printResult();
-		void printTip();
+		void printTime(std::ostream& out);
+		void printForm(std::ostream& out);
+		void printFill(std::ostream& out);
+		void printHelp(std::ostream& out);
+		void printResult(std::ostream& out);
+		void printTip(std::ostream& out);
 
-		const std::unordered_map<std::string, std::function<void()>> printFunctions{
-			{ "time", [&]() {this->printTime(); }},
-			{ "form", [&]() {this->printForm(); }},
-			{ "fill", [&]() {this->printFill(); }},
-			{ "help", [&]() {this->printHelp(); }},
-			{ "result", [&]() {this->printResult(); }},
-			{ "tip", [&]() {this->printTip(); }},
+		const std::unordered_map<std::string, std::function<void(std::ostream&)>> printFunctions{
+			{ "time", [&](std::ostream& out) {this->printTime(out); }},
+			{ "form", [&](std::ostream& out) {this->printForm(out); }},
+			{ "fill", [&](std::ostream& out) {this->printFill(out); }},
+			{ "help", [&](std::ostream& out) {this->printHelp(out); }},
+			{ "result", [&](std::ostream& out) {this->printResult(out); }},
+			{ "tip", [&](std::ostream& out) {this->printTip(out); }},
 		};
 
 		const std::vector<std::vector<Printer>> screens = {
@@ -47,13 +48,14 @@ namespace YYYCZ {
 		static constexpr int stateFinish = 3;
 		static constexpr int stateTip = 4;
 
-		FastSudoku result; // the sudoku result
+		FastSudoku::SolveResult result; // the sudoku result, only the solution
 		FastSudoku solver; // the sudoku solver
+		FrameRenderer renderer; // draw only the changes of frames
 
 		save_t row = 0; // the row of now selected
 		save_t column = 0; // the column of now selected
 		const int state = stateHelp; // now state of game
-		const int duration = 5; // the duration of gameframe (ms)
+		const int duration = 100; // the interval to redraw the clock when timing (ms)
 
 	protected:
 		// core process
@@ -63,11 +65,12 @@ namespace YYYCZ {
 		void fillNumber(save_t number);
 
 		void mainThread();
+		static std::vector<save_t> generateForm(index_t numberCount, save_t dim = 3);
 
 	public:
 		void gameStart(const std::vector<save_t>& form); // giving sudoku
-		void gameStart(); // random sudoku
-		void setDuration(const int duration); // set duration
+		bool gameStart(); // random sudoku, false if the input is closed
+		void setDuration(const int duration); // set the interval to redraw the clock
 
 	};
 }
@@ -0,0 +1,141 @@
+﻿// Code By YYYCZ
+
+#include "SudokuGeometry.h"
+#include <cctype>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
+namespace YYYCZ {
+	/// <summary>
+	/// get the boxes of the standard layout: square if the length is a square,
+	/// or the rectangle nearest to square, the rows less than the columns (2x3 for 6, 3x4 for 12)
+	/// </summary>
+	/// <param name="length">the length of the form</param>
+	/// <param name="rows">the rows of a box</param>
+	/// <param name="columns">the columns of a box</param>
+	/// <returns>false if no boxes, like the prime length</returns>
+	static bool standardBoxes(SudokuGeometry::index_t length, SudokuGeometry::index_t& rows, SudokuGeometry::index_t& columns)
+	{
+		if (length == 0) return false;
+		rows = (SudokuGeometry::index_t)std::sqrt((double)length);
+		while ((rows + 1) * (rows + 1) <= length) ++rows;
+		while (rows * rows > length) --rows;
+		while (length % rows) --rows;
+		columns = length / rows;
+		return rows > 1 || length == 1;
+	}
+
+	/// <summary>
+	/// make the places of every block from the blocks
+	/// </summary>
+	/// <param name="length">the length of the form</param>
+	/// <returns>false if a block is not length places</returns>
+	bool SudokuGeometry::build(index_t length)
+	{
+		formLength = length;
+		formSize = length * length;
+		if (length == 0 || blocks.size() != formSize) return false;
+
+		std::vector<index_t> count(length, 0);
+		places.assign(formSize, 0);
+		for (index_t place = 0; place < formSize; ++place) {
+			const index_t block = blocks[place];
+			if (block >= length || count[block] >= length) return false;
+			places[block * length + count[block]++] = place;
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// get the standard layout of the size, made once and shared
+	/// </summary>
+	/// <param name="size">the size of the form</param>
+	/// <returns>the layout, null if no sudoku of the size</returns>
+	std::shared_ptr<const SudokuGeometry> SudokuGeometry::standard(size_t size)
+	{
+		const index_t length = (index_t)std::lround(std::sqrt((double)size));
+		index_t rows = 0, columns = 0;
+		if ((size_t)length * length != size || !standardBoxes(length, rows, columns)) return nullptr;
+		return boxes(rows, columns);
+	}
+
+	/// <summary>
+	/// get the layout of boxes, made once and shared.
+	/// the boxes are numbered by rows, and the places of a box by rows
+	/// </summary>
+	/// <param name="rows">the rows of a box</param>
+	/// <param name="columns">the columns of a box</param>
+	/// <returns>the layout, null if too small or too large</returns>
+	std::shared_ptr<const SudokuGeometry> SudokuGeometry::boxes(index_t rows, index_t columns)
+	{
+		if (rows == 0 || columns == 0 || (unsigned long long)rows * columns > 0xFFFF) return nullptr;
+
+		static std::mutex lock;
+		static std::map<std::pair<index_t, index_t>, std::shared_ptr<const SudokuGeometry>> made;
+		std::lock_guard<std::mutex> guard(lock);
+		auto& geometry = made[{ rows, columns }];
+		if (geometry) return geometry;
+
+		const index_t length = rows * columns;
+		std::shared_ptr<SudokuGeometry> result(new SudokuGeometry());
+		result->boxRows = rows;
+		result->boxColumns = columns;
+		result->blocks.resize((size_t)length * length);
+		for (index_t place = 0; place < length * length; ++place) {
+			const index_t row = place / length, column = place % length;
+			result->blocks[place] = row / rows * (length / columns) + column / columns;
+		}
+		result->build(length);
+
+		index_t standardRows = 0, standardColumns = 0;
+		result->standardLayout = standardBoxes(length, standardRows, standardColumns) && standardRows == rows && standardColumns == columns;
+		geometry = result;
+		return geometry;
+	}
+
+	/// <summary>
+	/// make the layout of jigsaw regions
+	/// </summary>
+	/// <param name="blocks">the region of every place, from 0 to length - 1</param>
+	/// <returns>the layout, null if the size is not a square or a region is not length places</returns>
+	std::shared_ptr<const SudokuGeometry> SudokuGeometry::jigsaw(const std::vector<index_t>& blocks)
+	{
+		const index_t length = (index_t)std::lround(std::sqrt((double)blocks.size()));
+		if ((size_t)length * length != blocks.size()) return nullptr;
+
+		std::shared_ptr<SudokuGeometry> result(new SudokuGeometry());
+		result->blocks = blocks;
+		if (!result->build(length)) return nullptr;
+		return result;
+	}
+
+	/// <summary>
+	/// parse the layout of jigsaw regions, like "AAABBBCCC..." by rows.
+	/// a char is the region of a place, the regions are numbered by their first place
+	/// </summary>
+	/// <param name="text">the text of layout</param>
+	/// <returns>the layout, null if it is bad</returns>
+	std::shared_ptr<const SudokuGeometry> SudokuGeometry::parse(const std::string& text)
+	{
+		std::unordered_map<char, index_t> regions;
+		std::vector<index_t> blocks;
+		for (char ch : text) {
+			if (std::isspace((unsigned char)ch)) continue;
+			auto it = regions.emplace(ch, (index_t)regions.size()).first;
+			blocks.push_back(it->second);
+		}
+		return jigsaw(blocks);
+	}
+
+	/// <summary>
+	/// describe the layout
+	/// </summary>
+	/// <returns>like "3x3 boxes" or "jigsaw"</returns>
+	std::string SudokuGeometry::describe() const
+	{
+		if (isJigsaw()) return "jigsaw";
+		return std::to_string(boxRows) + "x" + std::to_string(boxColumns) + " boxes";
+	}
+}
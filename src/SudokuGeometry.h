@@ -0,0 +1,52 @@
+﻿// Code By YYYCZ
+
+#ifndef __YYYCZ_SUDOKU_GEOMETRY_H__
+#define __YYYCZ_SUDOKU_GEOMETRY_H__
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace YYYCZ {
+	// the blocks of a sudoku as tables: the block of every place, and the places of every block.
+	// the boxes (square, or rectangle like 2x3 for 6x6) and the jigsaw regions are the same tables,
+	// so the search only looks them up. a layout is made once and shared by all the sudokus of it.
+	// THREAD SAFE (read only after made)
+	class SudokuGeometry {
+	public:
+		using index_t = unsigned int;
+
+	private:
+		index_t formLength = 0; // the length of the form
+		index_t formSize = 0; // the size of the form
+		index_t boxRows = 0; // the rows of a box, 0 for jigsaw
+		index_t boxColumns = 0; // the columns of a box, 0 for jigsaw
+		bool standardLayout = false; // if it is the boxes of standard(size)
+		std::vector<index_t> blocks; // the block of every place
+		std::vector<index_t> places; // the places of every block, block * length + i, in the order of index
+
+		SudokuGeometry() = default;
+		bool build(index_t length); // the places from the blocks, false if a block is not length places
+
+	public:
+		static std::shared_ptr<const SudokuGeometry> standard(size_t size); // the boxes nearest to square, null if no sudoku of the size
+		static std::shared_ptr<const SudokuGeometry> boxes(index_t rows, index_t columns); // null if too small
+		static std::shared_ptr<const SudokuGeometry> jigsaw(const std::vector<index_t>& blocks); // null if the regions are not length places
+		static std::shared_ptr<const SudokuGeometry> parse(const std::string& text); // a char for the region of a place, the spaces are skipped
+
+		index_t getLength() const { return formLength; }
+		index_t getSize() const { return formSize; }
+		index_t getBoxRows() const { return boxRows; }
+		index_t getBoxColumns() const { return boxColumns; }
+		index_t getDimension() const { return boxRows == boxColumns ? boxRows : 0; } // 0 if the blocks are not square boxes
+		bool isJigsaw() const { return boxRows == 0; }
+		bool isStandard() const { return standardLayout; }
+		index_t blockOf(index_t place) const { return blocks[place]; }
+		index_t placeOf(index_t block, index_t i) const { return places[block * formLength + i]; }
+		const index_t* getBlocks() const { return blocks.data(); }
+		const index_t* getPlaces() const { return places.data(); }
+		std::string describe() const; // like "3x3 boxes" or "jigsaw"
+	};
+}
+
+#endif
@@ -5,6 +5,16 @@
 #include <Windows.h>
 #include <iostream>
 #include <conio.h>
+#include <cstdio>
+
+// the console of windows is raw for _getch already
+YYYCZ::ConsoleSession::ConsoleSession()
+{
+}
+
+YYYCZ::ConsoleSession::~ConsoleSession()
+{
+}
 
 int YYYCZ::judgeDirection(int key)
 {
@@ -41,6 +51,30 @@ bool YYYCZ::isKeyPressed()
 	return _kbhit();
 }
 
+bool YYYCZ::waitKeyPressed(int timeoutMs)
+{
+	// wait the console input, and drop the events which are not chars (mouse, focus, shift ...)
+	HANDLE handle = GetStdHandle(STD_INPUT_HANDLE);
+	ULONGLONG deadline = GetTickCount64() + (timeoutMs < 0 ? 0 : timeoutMs);
+	while (!_kbhit()) {
+		INPUT_RECORD record;
+		DWORD count = 0;
+		if (PeekConsoleInput(handle, &record, 1, &count) && count) {
+			ReadConsoleInput(handle, &record, 1, &count);
+			continue;
+		}
+
+		DWORD waitMs = INFINITE;
+		if (timeoutMs >= 0) {
+			ULONGLONG now = GetTickCount64();
+			if (now >= deadline) return false;
+			waitMs = (DWORD)(deadline - now);
+		}
+		if (WaitForSingleObject(handle, waitMs) != WAIT_OBJECT_0) return false;
+	}
+	return true;
+}
+
 int YYYCZ::getKeyPressed()
 {
 	return _getch();
@@ -51,6 +85,19 @@ void YYYCZ::wait(unsigned int ms)
 	Sleep(ms);
 }
 
+void YYYCZ::writeConsole(const char* data, size_t size)
+{
+	std::cout.flush();
+	fflush(stdout);
+	HANDLE handle = GetStdHandle(STD_OUTPUT_HANDLE);
+	while (size) {
+		DWORD written = 0;
+		if (!WriteFile(handle, data, (DWORD)size, &written, nullptr) || written == 0) return;
+		data += written;
+		size -= written;
+	}
+}
+
 #endif // _WIN32
 
 #ifdef __linux
@@ -59,12 +106,46 @@ void YYYCZ::wait(unsigned int ms)
 #include <unistd.h>
 #include <termio.h>
 #include <fcntl.h> 
+#include <poll.h>
+#include <cerrno>
+#include <cstdio>
+
+namespace {
+	int sessionDepth = 0; // count of nested sessions
+	bool sessionRaw = false; // if the console is changed by the session
+	struct termios sessionOld; // the console settings before the session
+
+	unsigned char inputBuffer[64]; // the keys read but not got
+	size_t inputBegin = 0, inputEnd = 0;
+	bool inputClosed = false; // if the input is closed
+}
+
+YYYCZ::ConsoleSession::ConsoleSession()
+{
+	if (sessionDepth++ != 0) return;
+	if (tcgetattr(STDIN_FILENO, &sessionOld) < 0) return;
+
+	// no echo and no line buffer, the signals still work
+	struct termios tm = sessionOld;
+	tm.c_lflag &= ~(ICANON | ECHO);
+	tm.c_cc[VMIN] = 1;
+	tm.c_cc[VTIME] = 0;
+	sessionRaw = tcsetattr(STDIN_FILENO, TCSANOW, &tm) == 0;
+}
+
+YYYCZ::ConsoleSession::~ConsoleSession()
+{
+	if (--sessionDepth != 0) return;
+	if (sessionRaw) tcsetattr(STDIN_FILENO, TCSANOW, &sessionOld);
+	sessionRaw = false;
+}
 
 int YYYCZ::judgeDirection(int key)
 {
-	if(key == '\033'){
-		if(isKeyPressed()){
-			int x1 = getKeyPressed();
+	// the rest of the sequence may come a little later (such as ssh)
+	if (key == '\033' && waitKeyPressed(30)) {
+		int x1 = getKeyPressed();
+		if (x1 == '[' || x1 == 'O') {
 			int x2 = getKeyPressed();
 			switch (x2)
 			{
@@ -95,48 +176,43 @@ void YYYCZ::setConsoleCursor(bool visiable)
 
 bool YYYCZ::isKeyPressed()
 {
-	struct termios oldt, newt;  
-	int ch;  
-	int oldf;  
-	tcgetattr(STDIN_FILENO, &oldt);  
-	newt = oldt;  
-	newt.c_lflag &= ~(ICANON | ECHO);  
-	tcsetattr(STDIN_FILENO, TCSANOW, &newt);  
-	oldf = fcntl(STDIN_FILENO, F_GETFL, 0);  
-	fcntl(STDIN_FILENO, F_SETFL, oldf | O_NONBLOCK); 
-	ch = getchar();  
-	tcsetattr(STDIN_FILENO, TCSANOW, &oldt);  
-	fcntl(STDIN_FILENO, F_SETFL, oldf);  
-	if(ch != EOF)  
-	{  
-		ungetc(ch, stdin);  
-		return true;  
-	}  
-	return false; 
+	return waitKeyPressed(0);
 }
 
-int YYYCZ::getKeyPressed()
+bool YYYCZ::waitKeyPressed(int timeoutMs)
 {
-	struct termios tm, tm_old;
-	int fd = 0, ch;
-
-	if (tcgetattr(fd, &tm) < 0) {
-		return -1;
-	}
-
-	tm_old = tm;
-	cfmakeraw(&tm);
-	if (tcsetattr(fd, TCSANOW, &tm) < 0) {
-		return -1;
+	// the closed input is always ready, and gets -1
+	if (inputBegin < inputEnd || inputClosed) return true;
+
+	ConsoleSession session;
+	struct pollfd fd = { STDIN_FILENO, POLLIN, 0 };
+	int ready;
+	do {
+		ready = poll(&fd, 1, timeoutMs);
+	} while (ready < 0 && errno == EINTR);
+	if (ready <= 0) return false;
+
+	// read all the bytes ready, such as the whole escape sequence
+	ssize_t size;
+	do {
+		size = read(STDIN_FILENO, inputBuffer, sizeof(inputBuffer));
+	} while (size < 0 && errno == EINTR);
+	if (size <= 0) {
+		inputClosed = true;
+		return true;
 	}
+	inputBegin = 0;
+	inputEnd = (size_t)size;
+	return true;
+}
 
-	ch = getchar();
-	if (tcsetattr(fd, TCSANOW, &tm_old) < 0) {
-		return -1;
+int YYYCZ::getKeyPressed()
+{
+	while (inputBegin == inputEnd) {
+		if (inputClosed) return -1;
+		waitKeyPressed(-1);
 	}
-
-	std::cout << "    \r";
-	return ch;
+	return inputBuffer[inputBegin++];
 }
 
 void YYYCZ::wait(unsigned int ms)
@@ -144,4 +220,19 @@ void YYYCZ::wait(unsigned int ms)
 	usleep(ms * 1000);
 }
 
+void YYYCZ::writeConsole(const char* data, size_t size)
+{
+	std::cout.flush();
+	fflush(stdout);
+	while (size) {
+		ssize_t written = write(STDOUT_FILENO, data, size);
+		if (written < 0) {
+			if (errno == EINTR) continue;
+			return;
+		}
+		data += written;
+		size -= written;
+	}
+}
+
 #endif // __linux
\ No newline at end of file
@@ -1,11 +1,31 @@
 ﻿// Code by YYYCZ
 
+#ifndef __YYYCZ_SUDOKU_HEADER_H__
+#define __YYYCZ_SUDOKU_HEADER_H__
+
+#include <cstddef>
+
 namespace YYYCZ {
 	int judgeDirection(int key); // judge if is direction control and return 0,1,2,3 (up,down,left,right) or -1(not direction)
 	void relocateConsole(); // relocate cursor in the console
 	void clearConsole(); // clear the console
 	void setConsoleCursor(bool visiable); // set the visibility of console's cursor
 	bool isKeyPressed(); // judge if some keys be pressed
-	int getKeyPressed(); // get the key be pressed
+	bool waitKeyPressed(int timeoutMs); // wait until some keys be pressed or timeout (-1 for never), return if pressed
+	int getKeyPressed(); // get the key be pressed, wait if no key, -1 if the input is closed
 	void wait(unsigned int ms); // wait x milliseconds
-}
\ No newline at end of file
+	void writeConsole(const char* data, size_t size); // write the bytes on the console by one call
+
+	// keep the console in raw mode (no echo, no line buffer) during the lifetime,
+	// the sessions can be nested and only the outermost one changes the console.
+	// the key functions without a session open a session for every call
+	class ConsoleSession {
+	public:
+		ConsoleSession();
+		ConsoleSession(const ConsoleSession&) = delete;
+		ConsoleSession& operator=(const ConsoleSession&) = delete;
+		~ConsoleSession();
+	};
+}
+
+#endif
\ No newline at end of file
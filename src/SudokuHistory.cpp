@@ -0,0 +1,287 @@
+﻿// Code By YYYCZ
+
+#include "SudokuHistory.h"
+#include <algorithm>
+
+namespace YYYCZ {
+	/// <summary>
+	/// build the trie of the form
+	/// </summary>
+	/// <param name="form">the form</param>
+	/// <param name="level">the level of node, 0 is leaf</param>
+	/// <param name="first">the first index of node</param>
+	/// <returns>node</returns>
+	SudokuHistory::node_ptr SudokuHistory::build(const std::vector<save_t>& form, index_t level, index_t first) const
+	{
+		auto node = std::make_shared<Node>();
+		if (level == 0) {
+			for (index_t i = 0; i < width && first + i < form.size(); ++i) {
+				node->values[i] = form[first + i];
+			}
+		}
+		else {
+			const index_t span = 1u << (bits * level);
+			for (index_t i = 0; i < width && first + i * span < form.size(); ++i) {
+				node->children[i] = build(form, level - 1, first + i * span);
+			}
+		}
+		return node;
+	}
+
+	/// <summary>
+	/// copy the path to the place and set the number
+	/// </summary>
+	/// <param name="node">the node</param>
+	/// <param name="level">the level of node, 0 is leaf</param>
+	/// <param name="index">index of place</param>
+	/// <param name="value">the number</param>
+	/// <returns>the new node</returns>
+	SudokuHistory::node_ptr SudokuHistory::set(const node_ptr& node, index_t level, index_t index, save_t value) const
+	{
+		auto copy = std::make_shared<Node>(*node);
+		const index_t slot = (index >> (bits * level)) & (width - 1);
+		if (level == 0) {
+			copy->values[slot] = value;
+		}
+		else {
+			copy->children[slot] = set(node->children[slot], level - 1, index, value);
+		}
+		return copy;
+	}
+
+	/// <summary>
+	/// find the places different, the shared nodes are skipped
+	/// </summary>
+	/// <param name="from">node of from</param>
+	/// <param name="to">node of to</param>
+	/// <param name="level">the level of node, 0 is leaf</param>
+	/// <param name="first">the first index of node</param>
+	/// <param name="changes">the places and numbers in "to"</param>
+	void SudokuHistory::diff(const node_ptr& from, const node_ptr& to, index_t level, index_t first,
+		std::vector<std::pair<index_t, save_t>>& changes) const
+	{
+		if (from == to || !from || !to) return;
+		if (level == 0) {
+			for (index_t i = 0; i < width && first + i < formSize; ++i) {
+				if (from->values[i] != to->values[i]) changes.emplace_back(first + i, to->values[i]);
+			}
+			return;
+		}
+		const index_t span = 1u << (bits * level);
+		for (index_t i = 0; i < width; ++i) {
+			diff(from->children[i], to->children[i], level - 1, first + i * span, changes);
+		}
+	}
+
+	/// <summary>
+	/// clear all versions, and take the form as the first version
+	/// </summary>
+	/// <param name="form">the form</param>
+	/// <returns>SudokuHistory</returns>
+	SudokuHistory& SudokuHistory::reset(const std::vector<save_t>& form)
+	{
+		clear();
+		formSize = (index_t)form.size();
+		depth = 0;
+		while ((1ull << (bits * (depth + 1))) < formSize) ++depth;
+		versions.push_back({ build(form, depth, 0) });
+		current = 0;
+		return *this;
+	}
+
+	/// <summary>
+	/// clear all versions
+	/// </summary>
+	/// <returns>SudokuHistory</returns>
+	SudokuHistory& SudokuHistory::clear()
+	{
+		formSize = depth = 0;
+		versions.clear();
+		checkpoints.clear();
+		current = noVersion;
+		return *this;
+	}
+
+	/// <summary>
+	/// judge if no version
+	/// </summary>
+	/// <returns>if is empty</returns>
+	bool SudokuHistory::empty() const
+	{
+		return versions.empty();
+	}
+
+	/// <summary>
+	/// get the number of now version
+	/// </summary>
+	/// <param name="index">index of place</param>
+	/// <returns>number</returns>
+	SudokuHistory::save_t SudokuHistory::get(index_t index) const
+	{
+		if (empty() || index >= formSize) return 0;
+		const Node* node = versions[current].root.get();
+		for (index_t level = depth; level > 0; --level) {
+			node = node->children[(index >> (bits * level)) & (width - 1)].get();
+		}
+		return node->values[index & (width - 1)];
+	}
+
+	/// <summary>
+	/// get the form of now version
+	/// </summary>
+	/// <returns>form</returns>
+	std::vector<SudokuHistory::save_t> SudokuHistory::getForm() const
+	{
+		std::vector<save_t> form(formSize);
+		for (index_t i = 0; i < formSize; ++i) form[i] = get(i);
+		return form;
+	}
+
+	/// <summary>
+	/// get the size of form
+	/// </summary>
+	/// <returns>size</returns>
+	SudokuHistory::index_t SudokuHistory::getFormSize() const
+	{
+		return formSize;
+	}
+
+	/// <summary>
+	/// make a new version by changing one place of now version, and go to it
+	/// </summary>
+	/// <param name="index">index of place</param>
+	/// <param name="value">the number, 0 for erase</param>
+	/// <returns>the new version</returns>
+	SudokuHistory::version_t SudokuHistory::apply(index_t index, save_t value)
+	{
+		if (empty() || index >= formSize) return noVersion;
+		Version version;
+		version.root = set(versions[current].root, depth, index, value);
+		version.parent = current;
+		versions.push_back(std::move(version));
+		current = versions[current].redo = (version_t)versions.size() - 1;
+		return current;
+	}
+
+	/// <summary>
+	/// go to the version before
+	/// </summary>
+	/// <returns>if undo</returns>
+	bool SudokuHistory::undo()
+	{
+		if (empty() || versions[current].parent == noVersion) return false;
+		current = versions[current].parent;
+		return true;
+	}
+
+	/// <summary>
+	/// go to the version undone, or the latest one made from now version
+	/// </summary>
+	/// <returns>if redo</returns>
+	bool SudokuHistory::redo()
+	{
+		if (empty() || versions[current].redo == noVersion) return false;
+		current = versions[current].redo;
+		return true;
+	}
+
+	/// <summary>
+	/// go to the first version, redo goes along the latest versions
+	/// </summary>
+	/// <returns>if restart</returns>
+	bool SudokuHistory::restart()
+	{
+		if (empty() || current == 0) return false;
+		current = 0;
+		return true;
+	}
+
+	/// <summary>
+	/// go to a version
+	/// </summary>
+	/// <param name="version">version</param>
+	/// <returns>if the version exists</returns>
+	bool SudokuHistory::goTo(version_t version)
+	{
+		if (version >= versions.size()) return false;
+		current = version;
+		return true;
+	}
+
+	/// <summary>
+	/// name now version as a checkpoint
+	/// </summary>
+	/// <param name="name">name</param>
+	/// <returns>SudokuHistory</returns>
+	SudokuHistory& SudokuHistory::setCheckpoint(const std::string& name)
+	{
+		if (!empty()) checkpoints[name] = current;
+		return *this;
+	}
+
+	/// <summary>
+	/// go to a checkpoint
+	/// </summary>
+	/// <param name="name">name</param>
+	/// <returns>if the checkpoint exists</returns>
+	bool SudokuHistory::checkout(const std::string& name)
+	{
+		auto itr = checkpoints.find(name);
+		return itr != checkpoints.end() && goTo(itr->second);
+	}
+
+	/// <summary>
+	/// judge if the checkpoint exists
+	/// </summary>
+	/// <param name="name">name</param>
+	/// <returns>if exists</returns>
+	bool SudokuHistory::hasCheckpoint(const std::string& name) const
+	{
+		return checkpoints.count(name) != 0;
+	}
+
+	/// <summary>
+	/// get the names of checkpoints
+	/// </summary>
+	/// <returns>names in order</returns>
+	std::vector<std::string> SudokuHistory::getCheckpoints() const
+	{
+		std::vector<std::string> names;
+		for (auto& i : checkpoints) names.push_back(i.first);
+		std::sort(names.begin(), names.end());
+		return names;
+	}
+
+	/// <summary>
+	/// get now version
+	/// </summary>
+	/// <returns>version</returns>
+	SudokuHistory::version_t SudokuHistory::getVersion() const
+	{
+		return current;
+	}
+
+	/// <summary>
+	/// get the count of versions
+	/// </summary>
+	/// <returns>count</returns>
+	SudokuHistory::version_t SudokuHistory::getVersionCount() const
+	{
+		return (version_t)versions.size();
+	}
+
+	/// <summary>
+	/// get the places different between two versions
+	/// </summary>
+	/// <param name="from">version from</param>
+	/// <param name="to">version to</param>
+	/// <returns>the places changed, and the numbers in "to"</returns>
+	std::vector<std::pair<SudokuHistory::index_t, SudokuHistory::save_t>> SudokuHistory::diff(version_t from, version_t to) const
+	{
+		std::vector<std::pair<index_t, save_t>> changes;
+		if (from < versions.size() && to < versions.size()) {
+			diff(versions[from].root, versions[to].root, depth, 0, changes);
+		}
+		return changes;
+	}
+}
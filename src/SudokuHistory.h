@@ -0,0 +1,83 @@
+﻿// Code By YYYCZ
+
+#ifndef __YYYCZ_SUDOKU_HISTORY_H__
+#define __YYYCZ_SUDOKU_HISTORY_H__
+
+#include <array>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace YYYCZ {
+	// the history of a game as a tree of versions.
+	// every version is a persistent form (a trie of 16 ways), changing one place copies
+	// only the path to it and shares the rest, so a version costs O(log n) memory.
+	// undo, redo, restart and going to a checkpoint only change the current version,
+	// and the difference of two versions skips the shared parts.
+	// NOT THREAD SAFE
+	class SudokuHistory {
+	public:
+		using save_t = int;
+		using index_t = unsigned int;
+		using version_t = unsigned int;
+
+		static constexpr version_t noVersion = (version_t)-1;
+
+	private:
+		static constexpr index_t bits = 4;
+		static constexpr index_t width = 1 << bits;
+
+		// the node of trie, the leaves keep the numbers
+		struct Node {
+			std::array<std::shared_ptr<const Node>, width> children;
+			std::array<save_t, width> values{};
+		};
+		using node_ptr = std::shared_ptr<const Node>;
+
+		// one version of the form
+		struct Version {
+			node_ptr root; // the form
+			version_t parent = noVersion; // the version before
+			version_t redo = noVersion; // the version to redo, the latest child
+		};
+
+		index_t formSize = 0; // the size of form
+		index_t depth = 0; // the levels of inner nodes
+		std::vector<Version> versions; // all versions
+		version_t current = noVersion; // now version
+		std::unordered_map<std::string, version_t> checkpoints; // the named versions
+
+		node_ptr build(const std::vector<save_t>& form, index_t level, index_t first) const;
+		node_ptr set(const node_ptr& node, index_t level, index_t index, save_t value) const;
+		void diff(const node_ptr& from, const node_ptr& to, index_t level, index_t first,
+			std::vector<std::pair<index_t, save_t>>& changes) const;
+
+	public:
+		SudokuHistory& reset(const std::vector<save_t>& form); // the form as the first version
+		SudokuHistory& clear();
+		bool empty() const;
+
+		save_t get(index_t index) const; // the number of now version
+		std::vector<save_t> getForm() const;
+		index_t getFormSize() const;
+
+		version_t apply(index_t index, save_t value); // a new version after now version, and go to it
+		bool undo(); // go to the parent
+		bool redo(); // go to the latest child
+		bool restart(); // go to the first version
+		bool goTo(version_t version);
+
+		SudokuHistory& setCheckpoint(const std::string& name); // name now version
+		bool checkout(const std::string& name); // go to the named version
+		bool hasCheckpoint(const std::string& name) const;
+		std::vector<std::string> getCheckpoints() const;
+
+		version_t getVersion() const;
+		version_t getVersionCount() const;
+		std::vector<std::pair<index_t, save_t>> diff(version_t from, version_t to) const; // the places changed, and the numbers in "to"
+	};
+}
+
+#endif
@@ -0,0 +1,624 @@
+﻿// Code By YYYCZ
+
+#include "SudokuIO.h"
+#include <algorithm>
+#include <cstring>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace YYYCZ {
+	/// <summary>
+	/// get the length of form if the size is size of sudoku form
+	/// </summary>
+	/// <param name="size">size</param>
+	/// <returns>length, 0 if not</returns>
+	static inline size_t lengthOfSize(size_t size)
+	{
+		size_t length = 1;
+		while (length * length < size) ++length;
+		return (length * length == size && length > 1) ? length : 0;
+	}
+
+	/// <summary>
+	/// judge if the char is the space
+	/// </summary>
+	/// <param name="c">char</param>
+	/// <returns>if is space</returns>
+	static inline bool isSpace(char c)
+	{
+		return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+	}
+
+	/// <summary>
+	/// map the file into memory
+	/// </summary>
+	/// <param name="path">path of file</param>
+	MappedFile::MappedFile(const std::string& path)
+	{
+		open(path);
+	}
+
+	/// <summary>
+	/// unmap the file
+	/// </summary>
+	MappedFile::~MappedFile()
+	{
+		close();
+	}
+
+	/// <summary>
+	/// map the file into memory, "-" to read stdin
+	/// </summary>
+	/// <param name="path">path of file</param>
+	/// <returns>if open successfully</returns>
+	bool MappedFile::open(const std::string& path)
+	{
+		close();
+
+		// read the whole file
+		auto readAll = [&](FILE* file) {
+			char chunk[1 << 16];
+			size_t n;
+			while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+				buffer.append(chunk, n);
+			}
+			data = buffer.data();
+			size = buffer.size();
+			return true;
+		};
+
+		if (path == "-") {
+			return readAll(stdin);
+		}
+
+#ifdef _WIN32
+		HANDLE hFile = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+			OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (hFile == INVALID_HANDLE_VALUE) return false;
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(hFile, &fileSize) || fileSize.QuadPart == 0) {
+			CloseHandle(hFile);
+			data = buffer.data();
+			return true;
+		}
+		HANDLE hMap = CreateFileMappingA(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		const void* p = hMap ? MapViewOfFile(hMap, FILE_MAP_READ, 0, 0, 0) : nullptr;
+		if (!p) {
+			if (hMap) CloseHandle(hMap);
+			CloseHandle(hFile);
+			FILE* file = fopen(path.c_str(), "rb");
+			if (!file) return false;
+			readAll(file);
+			fclose(file);
+			return true;
+		}
+		fileHandle = hFile;
+		mapHandle = hMap;
+		data = (const char*)p;
+		size = (size_t)fileSize.QuadPart;
+		mapped = true;
+		return true;
+#else
+		int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0) return false;
+
+		struct stat st;
+		if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+			void* p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (p != MAP_FAILED) {
+				madvise(p, (size_t)st.st_size, MADV_SEQUENTIAL);
+				::close(fd);
+				data = (const char*)p;
+				size = (size_t)st.st_size;
+				mapped = true;
+				return true;
+			}
+		}
+		::close(fd);
+
+		FILE* file = fopen(path.c_str(), "rb");
+		if (!file) return false;
+		readAll(file);
+		fclose(file);
+		return true;
+#endif
+	}
+
+	/// <summary>
+	/// unmap the file
+	/// </summary>
+	void MappedFile::close()
+	{
+		if (mapped) {
+#ifdef _WIN32
+			UnmapViewOfFile(data);
+			CloseHandle((HANDLE)mapHandle);
+			CloseHandle((HANDLE)fileHandle);
+			mapHandle = fileHandle = nullptr;
+#else
+			munmap((void*)data, size);
+#endif
+		}
+		data = nullptr;
+		size = 0;
+		mapped = false;
+		buffer.clear();
+	}
+
+	/// <summary>
+	/// judge if the file is open
+	/// </summary>
+	/// <returns>if is open</returns>
+	bool MappedFile::isOpen() const
+	{
+		return data != nullptr;
+	}
+
+	/// <summary>
+	/// get the content of file
+	/// </summary>
+	/// <returns>content</returns>
+	std::string_view MappedFile::view() const
+	{
+		return data ? std::string_view(data, size) : std::string_view();
+	}
+
+	/// <summary>
+	/// create the reader
+	/// </summary>
+	/// <param name="text">the text to read</param>
+	PuzzleReader::PuzzleReader(std::string_view text)
+		: text(text)
+	{
+	}
+
+	/// <summary>
+	/// get the next line and move forward
+	/// </summary>
+	/// <returns>the line without '\n'</returns>
+	inline std::string_view PuzzleReader::nextLine()
+	{
+		size_t end = text.find('\n', position);
+		if (end == std::string_view::npos) end = text.size();
+		std::string_view line = text.substr(position, end - position);
+		position = end < text.size() ? end + 1 : end;
+		++lineNumber;
+		return line;
+	}
+
+	/// <summary>
+	/// parse the sudoku of one line format
+	/// </summary>
+	/// <param name="token">the token of sudoku</param>
+	/// <param name="form">the form</param>
+	/// <returns>if parse successfully</returns>
+	bool PuzzleReader::parseLine(std::string_view token, std::vector<save_t>& form)
+	{
+		const save_t length = (save_t)lengthOfSize(token.size());
+
+		// the alphabet: hex if a 16x16 has '0' as a number ('.' is blank, or no blank at all) and no letter over 'F',
+		// else 'A' is 1 if no digits or some letters are too big, else 'A' is 10
+		bool digits = false, dots = false, unders = false;
+		size_t zeros = 0;
+		save_t letters = 0; // the biggest letter, 'A' is 1
+		for (char c : token) {
+			if ('1' <= c && c <= '9') digits = true;
+			else if (c == '0') ++zeros;
+			else if (c == '.') dots = true;
+			else if (c == '_') unders = true;
+			else if ('A' <= c && c <= 'Z') letters = std::max<save_t>(letters, c - 'A' + 1);
+			else if ('a' <= c && c <= 'z') letters = std::max<save_t>(letters, c - 'a' + 1);
+		}
+		if (length == 16 && zeros && !unders && letters <= 6 && (dots || zeros == 16)) alphabet = Alphabet_Hex;
+		else if (letters && (!digits || letters + 9 > length)) alphabet = Alphabet_Letters;
+		else alphabet = Alphabet_Digits;
+		const save_t letterBase = alphabet == Alphabet_Hex ? 11 : alphabet == Alphabet_Letters ? 1 : 10;
+		const save_t digitBase = alphabet == Alphabet_Hex ? 1 : 0;
+
+		form.resize(token.size());
+		save_t* cell = form.data();
+		for (char c : token) {
+			save_t v;
+			if (c == '.' || c == '_' || (c == '0' && alphabet != Alphabet_Hex)) v = 0;
+			else if ('0' <= c && c <= '9') v = c - '0' + digitBase;
+			else if ('A' <= c && c <= 'Z') v = c - 'A' + letterBase;
+			else if ('a' <= c && c <= 'z') v = c - 'a' + letterBase;
+			else return false;
+			if (v > length) return false;
+			*cell++ = v;
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// parse the sudoku of grid format
+	/// </summary>
+	/// <param name="line">the first line of sudoku</param>
+	/// <param name="form">the form</param>
+	/// <returns>if parse successfully</returns>
+	bool PuzzleReader::parseGrid(std::string_view line, std::vector<save_t>& form)
+	{
+		size_t count = 0, length = 0, need = 0;
+		bool ok = true;
+		form.clear();
+
+		// read the tokens of one line
+		auto readTokens = [&](std::string_view s) {
+			size_t i = 0;
+			while (i < s.size() && count < need) {
+				while (i < s.size() && (isSpace(s[i]) || s[i] == '|' || s[i] == '+')) ++i;
+				if (i == s.size()) break;
+
+				size_t begin = i;
+				while (i < s.size() && !isSpace(s[i]) && s[i] != '|' && s[i] != '+') ++i;
+				std::string_view token = s.substr(begin, i - begin);
+
+				save_t v = 0;
+				if (token == "." || token == "_") v = 0;
+				else if (token.size() == 1 && 'A' <= token[0] && token[0] <= 'Z') v = token[0] - 'A' + 10;
+				else if (token.size() == 1 && 'a' <= token[0] && token[0] <= 'z') v = token[0] - 'a' + 10;
+				else {
+					for (char c : token) {
+						if (c < '0' || c > '9') {
+							ok = false;
+							v = 0;
+							break;
+						}
+						v = v * 10 + (c - '0');
+					}
+				}
+				if ((size_t)v > length) ok = false;
+				form[count++] = v;
+			}
+		};
+
+		// the count of tokens of a line, '|' and '+' are not tokens
+		auto countTokens = [](std::string_view s) {
+			size_t tokens = 0;
+			for (size_t i = 0; i < s.size(); ) {
+				while (i < s.size() && (isSpace(s[i]) || s[i] == '|' || s[i] == '+')) ++i;
+				if (i == s.size()) break;
+				++tokens;
+				while (i < s.size() && !isSpace(s[i]) && s[i] != '|' && s[i] != '+') ++i;
+			}
+			return tokens;
+		};
+
+		// the count of tokens in first line is the length,
+		// or is the size if all in one line
+		const size_t tokens = countTokens(line);
+		if (tokens >= 81 && lengthOfSize(tokens)) {
+			length = lengthOfSize(tokens);
+		}
+		else if (lengthOfSize(tokens * tokens)) {
+			length = tokens;
+		}
+		else {
+			return false;
+		}
+		need = length * length;
+		form.resize(need);
+
+		// every row of a multi-line grid has just the length of tokens,
+		// a bad row is not read, so a bad line doesn't take the sudokus after it
+		readTokens(line);
+		while (count < need && position < text.size()) {
+			size_t before = position, lineBefore = lineNumber;
+			std::string_view s = nextLine();
+
+			// skip the separator lines
+			size_t k = 0;
+			while (k < s.size() && (isSpace(s[k]) || s[k] == '-' || s[k] == '+' || s[k] == '|')) ++k;
+			if (k == s.size()) continue;
+
+			// the comment or a row of other length means the grid is broken,
+			// unless it is the last line cut by the end
+			if (s[k] == '#' || countTokens(s) != length) {
+				cut = partial && position == text.size() && text.back() != '\n' && s[k] != '#';
+				position = before;
+				lineNumber = lineBefore;
+				return false;
+			}
+			readTokens(s);
+		}
+		cut = count < need && position == text.size();
+		return ok && count == need;
+	}
+
+	/// <summary>
+	/// read the next sudoku
+	/// </summary>
+	/// <param name="form">the form read</param>
+	/// <returns>if read, false if no more sudoku</returns>
+	bool PuzzleReader::next(std::vector<save_t>& form)
+	{
+		while (position < text.size()) {
+			const size_t begin = position, beginLine = lineNumber;
+			std::string_view line = nextLine();
+
+			// the last line may be cut
+			if (partial && position == text.size() && text.back() != '\n') {
+				position = begin;
+				lineNumber = beginLine;
+				return false;
+			}
+
+			// skip the spaces
+			size_t first = 0;
+			while (first < line.size() && isSpace(line[first])) ++first;
+			if (first == line.size() || line[first] == '#') continue;
+
+			// the first token
+			size_t end = first;
+			while (end < line.size() && !isSpace(line[end]) && line[end] != ',' && line[end] != ';' && line[end] != '|') ++end;
+			std::string_view token = line.substr(first, end - first);
+
+			cut = false;
+			alphabet = Alphabet_Digits;
+			bool ok = (token.size() >= 16 && lengthOfSize(token.size()))
+				? parseLine(token, form)
+				: parseGrid(line.substr(first), form);
+			if (ok) return true;
+			if (partial && cut) {
+				position = begin;
+				lineNumber = beginLine;
+				return false;
+			}
+			++errorCount;
+		}
+		return false;
+	}
+
+	/// <summary>
+	/// reset the text to read
+	/// </summary>
+	/// <param name="text">text</param>
+	/// <returns>PuzzleReader</returns>
+	PuzzleReader& PuzzleReader::reset(std::string_view text)
+	{
+		this->text = text;
+		position = lineNumber = errorCount = 0;
+		return *this;
+	}
+
+	/// <summary>
+	/// set if the text may be cut at the end, such as reading a stream block by block.
+	/// if partial, the sudoku cut by the end is left, and the position stays at its beginning
+	/// </summary>
+	/// <param name="flag">new flag</param>
+	/// <returns>PuzzleReader</returns>
+	PuzzleReader& PuzzleReader::setPartial(bool flag)
+	{
+		this->partial = flag;
+		return *this;
+	}
+
+	/// <summary>
+	/// get the position read
+	/// </summary>
+	/// <returns>position</returns>
+	size_t PuzzleReader::getPosition() const
+	{
+		return position;
+	}
+
+	/// <summary>
+	/// get the line number read
+	/// </summary>
+	/// <returns>line number</returns>
+	size_t PuzzleReader::getLineNumber() const
+	{
+		return lineNumber;
+	}
+
+	/// <summary>
+	/// get the count of bad sudoku skipped
+	/// </summary>
+	/// <returns>count</returns>
+	size_t PuzzleReader::getErrorCount() const
+	{
+		return errorCount;
+	}
+
+	/// <summary>
+	/// get the alphabet of the last sudoku read, so it can be written back the same
+	/// </summary>
+	/// <returns>PuzzleReader::Alphabet_*, Alphabet_Digits for the grid format</returns>
+	char PuzzleReader::getAlphabet() const
+	{
+		return alphabet;
+	}
+
+	/// <summary>
+	/// open the file to write
+	/// </summary>
+	/// <param name="path">path of file, "-" for stdout</param>
+	/// <param name="format">format of sudoku</param>
+	/// <param name="bufferSize">size of buffer</param>
+	PuzzleWriter::PuzzleWriter(const std::string& path, char format, size_t bufferSize)
+		: format(format), buffer(bufferSize, '\0')
+	{
+		if (path == "-") {
+			file = stdout;
+		}
+		else {
+			file = fopen(path.c_str(), "wb");
+			ownFile = true;
+		}
+	}
+
+	/// <summary>
+	/// write to the opened file
+	/// </summary>
+	/// <param name="file">file</param>
+	/// <param name="format">format of sudoku</param>
+	/// <param name="bufferSize">size of buffer</param>
+	PuzzleWriter::PuzzleWriter(FILE* file, char format, size_t bufferSize)
+		: file(file), format(format), buffer(bufferSize, '\0')
+	{
+	}
+
+	/// <summary>
+	/// flush and close the file
+	/// </summary>
+	PuzzleWriter::~PuzzleWriter()
+	{
+		flush();
+		if (ownFile && file) fclose(file);
+	}
+
+	/// <summary>
+	/// make sure the buffer have enough space
+	/// </summary>
+	/// <param name="size">size need</param>
+	inline void PuzzleWriter::reserve(size_t size)
+	{
+		if (used + size > buffer.size()) {
+			flush();
+			if (size > buffer.size()) buffer.resize(size);
+		}
+	}
+
+	/// <summary>
+	/// judge if the file is open
+	/// </summary>
+	/// <returns>if is open</returns>
+	bool PuzzleWriter::isOpen() const
+	{
+		return file != nullptr;
+	}
+
+	/// <summary>
+	/// judge if all the writing succeeded, the buffer not flushed is not checked
+	/// </summary>
+	/// <returns>if open and nothing failed</returns>
+	bool PuzzleWriter::good() const
+	{
+		return file != nullptr && !failed;
+	}
+
+	/// <summary>
+	/// set the alphabet of the one line format, such as the alphabet the sudoku was read in
+	/// </summary>
+	/// <param name="alphabet">PuzzleReader::Alphabet_*</param>
+	/// <returns>PuzzleWriter</returns>
+	PuzzleWriter& PuzzleWriter::setAlphabet(char alphabet)
+	{
+		this->alphabet = alphabet;
+		return *this;
+	}
+
+	/// <summary>
+	/// write one sudoku
+	/// </summary>
+	/// <param name="form">form, empty form writes empty line</param>
+	/// <returns>PuzzleWriter</returns>
+	PuzzleWriter& PuzzleWriter::write(const std::vector<save_t>& form)
+	{
+		reserve(formatSize(form.size(), format));
+		used += formatForm(form, &buffer[used], format, alphabet);
+		return *this;
+	}
+
+	/// <summary>
+	/// write raw text
+	/// </summary>
+	/// <param name="text">text</param>
+	/// <returns>PuzzleWriter</returns>
+	PuzzleWriter& PuzzleWriter::write(std::string_view text)
+	{
+		reserve(text.size());
+		std::memcpy(&buffer[used], text.data(), text.size());
+		used += text.size();
+		return *this;
+	}
+
+	/// <summary>
+	/// write the buffer into the file
+	/// </summary>
+	/// <returns>PuzzleWriter</returns>
+	PuzzleWriter& PuzzleWriter::flush()
+	{
+		if (file && used) {
+			if (fwrite(buffer.data(), 1, used, file) != used) failed = true;
+			if (fflush(file) != 0) failed = true;
+		}
+		used = 0;
+		return *this;
+	}
+
+	/// <summary>
+	/// get the max size of one formatted sudoku
+	/// </summary>
+	/// <param name="cells">count of cells</param>
+	/// <param name="format">format</param>
+	/// <returns>size</returns>
+	size_t PuzzleWriter::formatSize(size_t cells, char format)
+	{
+		size_t length = lengthOfSize(cells);
+		if (format == Format_Line && length <= 35) return cells + 1;
+		return cells * 11 + length + 2;
+	}
+
+	/// <summary>
+	/// format one sudoku
+	/// </summary>
+	/// <param name="form">form</param>
+	/// <param name="out">output, size should be at least formatSize</param>
+	/// <param name="format">format</param>
+	/// <param name="alphabet">alphabet of one line format, PuzzleReader::Alphabet_*</param>
+	/// <returns>size written</returns>
+	size_t PuzzleWriter::formatForm(const std::vector<save_t>& form, char* out, char format, char alphabet)
+	{
+		const size_t length = lengthOfSize(form.size());
+		const char* symbols = ".123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+		if (alphabet == PuzzleReader::Alphabet_Hex && length == 16) symbols = ".0123456789ABCDEF";
+		else if (alphabet == PuzzleReader::Alphabet_Letters && length <= 26) symbols = ".ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+		char* p = out;
+
+		if (form.empty()) {
+			*p++ = '\n';
+			return p - out;
+		}
+
+		// one char one cell
+		if (format == Format_Line && length <= 35) {
+			for (auto v : form) {
+				*p++ = (0 <= v && v <= 35) ? symbols[v] : '.';
+			}
+			*p++ = '\n';
+			return p - out;
+		}
+
+		// numbers separated by spaces
+		size_t column = 0;
+		for (auto v : form) {
+			char digits[12];
+			int n = 0;
+			unsigned int u = v > 0 ? (unsigned int)v : 0;
+			do {
+				digits[n++] = char('0' + u % 10);
+				u /= 10;
+			} while (u);
+			while (n) *p++ = digits[--n];
+
+			if (++column == length && format == Format_Grid) {
+				*p++ = '\n';
+				column = 0;
+			}
+			else {
+				*p++ = ' ';
+			}
+		}
+		if (format == Format_Line) p[-1] = '\n';
+		else *p++ = '\n';
+		return p - out;
+	}
+}
@@ -0,0 +1,118 @@
+﻿// Code By YYYCZ
+
+#ifndef __YYYCZ_SUDOKU_IO_H__
+#define __YYYCZ_SUDOKU_IO_H__
+
+#include "FastSudoku.h"
+#include <string>
+#include <string_view>
+#include <cstdio>
+
+namespace YYYCZ {
+	// a read only file mapped into memory.
+	// if can't map (such as pipe), read the whole file into memory
+	class MappedFile {
+		const char* data = nullptr; // the content of file
+		size_t size = 0; // the size of file
+		bool mapped = false; // if the data is mapped
+		std::string buffer; // the content when not mapped
+#ifdef _WIN32
+		void* fileHandle = nullptr;
+		void* mapHandle = nullptr;
+#endif
+
+	public:
+		MappedFile() = default;
+		MappedFile(const std::string& path); // "-" to read stdin
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		~MappedFile();
+
+		bool open(const std::string& path);
+		void close();
+		bool isOpen() const;
+		std::string_view view() const;
+	};
+
+	// read the sudoku forms one by one from the text, without copying the text.
+	// support these formats:
+	// 1. one line one sudoku, such as "74.63....", blank can be '.', '0' or '_',
+	//    numbers bigger than 9 are 'A'(10), 'B'(11) ..., or 'A'(1), 'B'(2) ... if no digits or some letters are too big for that,
+	//    and a 16x16 of '0' to 'F' with '.' as blank is hex ('0' is 1, 'F' is 16);
+	// 2. the grid separated by spaces (may be multi-lines), such as "7 4 0 6 3 0 0 0 0\n...",
+	//    '|', '+' and lines of '-' are ignored.
+	// empty lines and the lines begin with '#' are skipped.
+	class PuzzleReader {
+	public:
+		using save_t = FastSudoku::save_t;
+		using index_t = FastSudoku::index_t;
+
+		static constexpr char Alphabet_Digits = 0; // '1' to '9', then 'A'(10), 'B'(11) ...
+		static constexpr char Alphabet_Letters = 1; // 'A'(1), 'B'(2) ...
+		static constexpr char Alphabet_Hex = 2; // '0'(1) to 'F'(16)
+
+	private:
+		std::string_view text; // the text
+		size_t position = 0; // now position
+		size_t lineNumber = 0; // now line number
+		size_t errorCount = 0; // the count of bad sudoku skipped
+		bool partial = false; // if the text may be cut at the end
+		bool cut = false; // if the last sudoku is cut by the end of text
+		char alphabet = Alphabet_Digits; // the alphabet of the last sudoku read
+
+		std::string_view nextLine();
+		bool parseLine(std::string_view token, std::vector<save_t>& form);
+		bool parseGrid(std::string_view line, std::vector<save_t>& form);
+
+	public:
+		PuzzleReader(std::string_view text = std::string_view());
+
+		bool next(std::vector<save_t>& form); // read next sudoku, return false if no more
+		PuzzleReader& reset(std::string_view text);
+		PuzzleReader& setPartial(bool flag); // if partial, the sudoku cut by the end is not skipped but left
+		size_t getPosition() const;
+		size_t getLineNumber() const;
+		size_t getErrorCount() const;
+		char getAlphabet() const; // the alphabet of the last sudoku read, the grid is Alphabet_Digits
+	};
+
+	// write the sudoku forms into the file with a big buffer, not use iostream
+	class PuzzleWriter {
+	public:
+		using save_t = FastSudoku::save_t;
+
+		static constexpr char Format_Line = 0; // one line one sudoku
+		static constexpr char Format_Grid = 1; // grid separated by spaces, and an empty line after it
+
+	private:
+		FILE* file = nullptr; // the file
+		bool ownFile = false; // if need to close the file
+		char format = Format_Line; // the format
+		char alphabet = PuzzleReader::Alphabet_Digits; // the alphabet of one line format
+		bool failed = false; // if some writing failed, such as the disk is full
+		std::string buffer; // the buffer
+		size_t used = 0; // used size of buffer
+
+		void reserve(size_t size);
+
+	public:
+		PuzzleWriter(const std::string& path, char format = Format_Line, size_t bufferSize = 1 << 16); // "-" for stdout
+		PuzzleWriter(FILE* file, char format = Format_Line, size_t bufferSize = 1 << 16);
+		PuzzleWriter(const PuzzleWriter&) = delete;
+		PuzzleWriter& operator=(const PuzzleWriter&) = delete;
+		~PuzzleWriter();
+
+		bool isOpen() const;
+		bool good() const; // open and nothing failed to write, check it after flush
+		PuzzleWriter& setAlphabet(char alphabet); // PuzzleReader::Alphabet_*, for the sudokus after it
+		PuzzleWriter& write(const std::vector<save_t>& form); // write one sudoku, empty form writes empty line
+		PuzzleWriter& write(std::string_view text); // write raw text
+		PuzzleWriter& flush();
+
+		static size_t formatSize(size_t cells, char format); // max size of one formatted sudoku
+		static size_t formatForm(const std::vector<save_t>& form, char* out, char format,
+			char alphabet = PuzzleReader::Alphabet_Digits); // return the size written
+	};
+}
+
+#endif
@@ -0,0 +1,513 @@
+﻿// Code By YYYCZ
+
+#include "SudokuPipeline.h"
+#include "SudokuCache.h"
+#include "SudokuIO.h"
+#include "SudokuCorpus.h"
+#include "SudokuValidator.h"
+#include <map>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace YYYCZ {
+	/// <summary>
+	/// set the count of solvers
+	/// </summary>
+	/// <param name="count">count, 0 for hardware concurrency</param>
+	/// <returns>SolvePipeline</returns>
+	SolvePipeline& SolvePipeline::setWorkerCount(index_t count)
+	{
+		this->workerCount = count;
+		return *this;
+	}
+
+	/// <summary>
+	/// set the count of chunks in one queue
+	/// </summary>
+	/// <param name="size">size</param>
+	/// <returns>SolvePipeline</returns>
+	SolvePipeline& SolvePipeline::setQueueSize(index_t size)
+	{
+		this->queueSize = size ? size : 1;
+		return *this;
+	}
+
+	/// <summary>
+	/// set the count of sudokus in one chunk
+	/// </summary>
+	/// <param name="size">size</param>
+	/// <returns>SolvePipeline</returns>
+	SolvePipeline& SolvePipeline::setChunkSize(index_t size)
+	{
+		this->chunkSize = size ? size : 1;
+		return *this;
+	}
+
+	/// <summary>
+	/// set the format of output
+	/// </summary>
+	/// <param name="format">PuzzleWriter::Format_Line or PuzzleWriter::Format_Grid</param>
+	/// <returns>SolvePipeline</returns>
+	SolvePipeline& SolvePipeline::setOutputFormat(char format)
+	{
+		this->outputFormat = format;
+		return *this;
+	}
+
+	/// <summary>
+	/// set if write the solutions into a binary corpus instead of text
+	/// </summary>
+	/// <param name="flag">flag</param>
+	/// <returns>SolvePipeline</returns>
+	SolvePipeline& SolvePipeline::setCorpusOutput(bool flag)
+	{
+		this->corpusOutput = flag;
+		return *this;
+	}
+
+	/// <summary>
+	/// set the cache of solutions shared by the solvers
+	/// </summary>
+	/// <param name="cache">cache, null if not use</param>
+	/// <returns>SolvePipeline</returns>
+	SolvePipeline& SolvePipeline::setSolutionCache(SolutionCache* cache)
+	{
+		this->solutionCache = cache;
+		return *this;
+	}
+
+	/// <summary>
+	/// set the options of solving, the limits stop the pathological sudokus
+	/// </summary>
+	/// <param name="options">options</param>
+	/// <returns>SolvePipeline</returns>
+	SolvePipeline& SolvePipeline::setSolveOptions(const FastSudoku::SolveOptions& options)
+	{
+		this->solveOptions = options;
+		return *this;
+	}
+
+	/// <summary>
+	/// set if validate the sudokus before solving: the contradictory ones are thrown away without search,
+	/// and the ones filled by the singles are not searched
+	/// </summary>
+	/// <param name="flag">new flag</param>
+	/// <returns>SolvePipeline</returns>
+	SolvePipeline& SolvePipeline::setValidation(bool flag)
+	{
+		this->validation = flag;
+		return *this;
+	}
+
+	/// <summary>
+	/// route the heavy sudokus to other options: the full search tree of every sudoku is estimated by some random probes first,
+	/// and the ones whose tree is over the bound are solved by the heavy options (like the SAT backend).
+	/// the tree is of all the solutions, so the bound should be far over the nodes of solving
+	/// </summary>
+	/// <param name="nodes">the bound of nodes of the tree, 0 for no route</param>
+	/// <param name="options">the options of heavy sudokus</param>
+	/// <param name="probes">the probes of estimating</param>
+	/// <returns>SolvePipeline</returns>
+	SolvePipeline& SolvePipeline::setHeavyRoute(double nodes, const FastSudoku::SolveOptions& options, index_t probes)
+	{
+		this->heavyNodes = nodes;
+		this->heavyOptions = options;
+		this->estimateOptions.probes = probes;
+		return *this;
+	}
+
+	/// <summary>
+	/// solve all the sudokus of input, and write the solutions to output in the same order.
+	/// the sudoku without solution writes an empty line (or an empty form in the corpus)
+	/// </summary>
+	/// <param name="input">input file, text or binary corpus, "-" for stdin</param>
+	/// <param name="output">output file, "-" for stdout</param>
+	/// <returns>if run successfully, false if can't open the files, can't write the output, or the variant doesn't fit</returns>
+	bool SolvePipeline::run(const std::string& input, const std::string& output)
+	{
+		using clock = FastSudoku::clock_t;
+		auto seconds = [](decltype(clock::now()) begin, decltype(clock::now()) end) {
+			return std::chrono::duration<double>(end - begin).count();
+		};
+
+		// the binary corpus is found by the magic, others are read as text
+		CorpusReader corpus;
+		FILE* in = nullptr;
+		outputGood = variantGood = true;
+		if (CorpusReader::isCorpus(input)) {
+			if (!corpus.open(input)) return false;
+		}
+		else {
+			in = input == "-" ? stdin : fopen(input.c_str(), "rb");
+			if (!in) return false;
+		}
+
+		std::unique_ptr<PuzzleWriter> textWriter;
+		std::unique_ptr<CorpusWriter> corpusWriter;
+		if (corpusOutput) corpusWriter.reset(new CorpusWriter(output));
+		else textWriter.reset(new PuzzleWriter(output, outputFormat));
+		if (corpusOutput ? !corpusWriter->isOpen() : !textWriter->isOpen()) {
+			if (in && in != stdin) fclose(in);
+			return false;
+		}
+
+		const index_t workers = workerCount ? workerCount : std::max(1u, std::thread::hardware_concurrency());
+		const size_t window = (size_t)queueSize * 2 + workers; // max chunks not written
+		BoundedQueue<Chunk> inQueue(queueSize), outQueue(queueSize);
+		std::atomic<size_t> written{ 0 }; // count of chunks written
+		std::atomic<index_t> runningWorkers{ workers };
+		std::atomic<size_t> unsolved{ 0 };
+		std::atomic<size_t> exhausted{ 0 };
+		std::atomic<size_t> heavy{ 0 };
+		std::atomic<size_t> rejected{ 0 };
+
+		readerStats = StageStats();
+		solverStats = StageStats();
+		writerStats = StageStats();
+		solverStats.threads = workers;
+		badCount = unsolvedCount = exhaustedCount = heavyCount = rejectedCount = 0;
+		const auto tpBegin = clock::now();
+
+		// solvers
+		std::vector<StageStats> workerStats(workers);
+		std::vector<std::thread> threads;
+		for (index_t w = 0; w < workers; ++w) {
+			threads.emplace_back([&, w]() {
+				FastSudoku solver;
+				const FastSudoku::SolveOptions options = solveOptions;
+				FastSudoku::EstimateOptions estimating = estimateOptions;
+				estimating.geometry = options.geometry;
+				SudokuValidator validator;
+				validator.setGeometry(options.geometry);
+				solver.setSolutionCache(solutionCache);
+				StageStats& stats = workerStats[w];
+				Chunk chunk;
+
+				while (true) {
+					auto t0 = clock::now();
+					if (!inQueue.pop(chunk)) break;
+					auto t1 = clock::now();
+					for (auto& form : chunk.forms) {
+						if (form.empty()) continue; // bad, counted by the reader
+
+						// the contradictory sudokus are thrown away and the ones filled by the singles are solved, without search.
+						// the rules of variant are not checked by the validator, so it only throws away
+						if (validation) {
+							auto report = validator.validate(form);
+							if (report.status == SudokuValidator::Status_Solved && !options.variant) {
+								form = validator.getForm();
+								continue;
+							}
+							if (!report.isValid() && report.status != SudokuValidator::Status_BadSize) {
+								form.clear();
+								++rejected;
+								++unsolved;
+								continue;
+							}
+						}
+
+						// the solution is moved out, the sudoku whose size is wrong is invalid
+						const bool isHeavy = heavyNodes > 0 && solver.estimate(form, estimating).nodes > heavyNodes;
+						if (isHeavy) ++heavy;
+						auto result = solver.solve(form, isHeavy ? heavyOptions : options);
+						form.swap(result.solution);
+						if (result.status == FastSudoku::SolveResult::Status_BudgetExhausted ||
+							result.status == FastSudoku::SolveResult::Status_Cancelled) ++exhausted;
+						else if (form.empty()) ++unsolved;
+					}
+					stats.items += chunk.forms.size();
+					auto t2 = clock::now();
+					outQueue.push(chunk);
+					auto t3 = clock::now();
+					stats.busy += seconds(t1, t2);
+					stats.wait += seconds(t0, t1) + seconds(t2, t3);
+				}
+
+				// the last solver closes the output
+				if (--runningWorkers == 0) outQueue.close();
+			});
+		}
+
+		// writer, keeps the order of input
+		threads.emplace_back([&]() {
+			std::map<size_t, Chunk> pending;
+			Chunk chunk;
+			while (true) {
+				auto t0 = clock::now();
+				if (!outQueue.pop(chunk)) break;
+				auto t1 = clock::now();
+				pending.emplace(chunk.sequence, std::move(chunk));
+				while (!pending.empty() && pending.begin()->first == written) {
+					// the solutions are written in the alphabet of the sudokus
+					const Chunk& done = pending.begin()->second;
+					for (size_t i = 0; i < done.forms.size(); ++i) {
+						if (corpusWriter) corpusWriter->write(done.forms[i]);
+						else if (i < done.alphabets.size()) textWriter->setAlphabet(done.alphabets[i]).write(done.forms[i]);
+						else textWriter->write(done.forms[i]);
+					}
+					writerStats.items += done.forms.size();
+					pending.erase(pending.begin());
+					++written;
+				}
+				auto t2 = clock::now();
+				writerStats.busy += seconds(t1, t2);
+				writerStats.wait += seconds(t0, t1);
+			}
+			auto t0 = clock::now();
+			if (corpusWriter) outputGood = corpusWriter->close();
+			else outputGood = textWriter->flush().good();
+			writerStats.busy += seconds(t0, clock::now());
+		});
+
+		// reader, read block by block in this thread
+		{
+			const size_t blockSize = 1 << 20;
+			std::string block;
+			std::vector<char> buffer(blockSize);
+			PuzzleReader reader;
+			Chunk chunk;
+			std::vector<save_t> form;
+			size_t consumed = 0;
+			bool eof = false;
+
+			auto pushChunk = [&]() {
+				auto t0 = clock::now();
+				unsigned int times = 0;
+				while (chunk.sequence >= written + window) {
+					std::this_thread::sleep_for(std::chrono::microseconds(times++ < 16 ? 10 : 200));
+				}
+				readerStats.items += chunk.forms.size();
+				size_t next = chunk.sequence + 1;
+				inQueue.push(chunk);
+				chunk.forms.clear();
+				chunk.alphabets.clear();
+				chunk.sequence = next;
+				readerStats.wait += seconds(t0, clock::now());
+			};
+
+			// the rules of variant must fit the length of sudokus, or the run stops before solving them
+			index_t fitLength = 0;
+			auto variantFits = [&](const std::vector<save_t>& f) {
+				if (!solveOptions.variant || f.empty()) return true;
+				const index_t length = (index_t)std::lround(std::sqrt((double)f.size()));
+				if (length == fitLength || (size_t)length * length != f.size()) return true;
+				fitLength = length;
+				variantGood = solveOptions.variant->tablesOf(length).valid;
+				return variantGood;
+			};
+
+			// the corpus is read block by block without parsing
+			if (corpus.isOpen()) {
+				std::vector<std::vector<save_t>> forms;
+				for (index_t b = 0; b < corpus.getBlockCount(); ++b) {
+					auto t0 = clock::now();
+					// a bad block is written as empty lines, so the output keeps the order of input
+					if (!corpus.readBlock(b, forms)) {
+						const size_t items = (size_t)std::min<uint64_t>(corpus.getBlockSize(), corpus.getCount() - (uint64_t)b * corpus.getBlockSize());
+						forms.assign(items, std::vector<save_t>());
+					}
+					for (auto& f : forms) {
+						if (!variantFits(f)) break;
+						if (f.empty()) ++badCount; // an empty form of the corpus (such as no solution) or of a bad block
+						chunk.forms.push_back(std::move(f));
+						if (chunk.forms.size() >= chunkSize) {
+							readerStats.busy += seconds(t0, clock::now());
+							pushChunk();
+							t0 = clock::now();
+						}
+					}
+					readerStats.busy += seconds(t0, clock::now());
+					if (!variantGood) break;
+				}
+				eof = true;
+			}
+
+			while (!eof) {
+				auto t0 = clock::now();
+				block.erase(0, consumed);
+				size_t n = fread(buffer.data(), 1, blockSize, in);
+				block.append(buffer.data(), n);
+				eof = n == 0;
+
+				// a bad sudoku is an empty form written as an empty line, so the output keeps the order of input
+				reader.reset(block).setPartial(!eof);
+				size_t errors = 0;
+				while (true) {
+					const bool read = reader.next(form);
+					if (read && !variantFits(form)) {
+						eof = true;
+						break;
+					}
+					for (; errors < reader.getErrorCount(); ++errors) {
+						chunk.forms.emplace_back();
+						chunk.alphabets.push_back(PuzzleReader::Alphabet_Digits);
+					}
+					if (read) {
+						chunk.forms.push_back(form);
+						chunk.alphabets.push_back(reader.getAlphabet());
+					}
+					if (chunk.forms.size() >= chunkSize) {
+						readerStats.busy += seconds(t0, clock::now());
+						pushChunk();
+						t0 = clock::now();
+					}
+					if (!read) break;
+				}
+				consumed = reader.getPosition();
+				badCount += errors;
+				readerStats.busy += seconds(t0, clock::now());
+			}
+			if (!chunk.forms.empty()) pushChunk();
+			inQueue.close();
+		}
+
+		for (auto& t : threads) t.join();
+		if (in && in != stdin) fclose(in);
+
+		for (auto& stats : workerStats) {
+			solverStats.items += stats.items;
+			solverStats.busy += stats.busy;
+			solverStats.wait += stats.wait;
+		}
+		unsolvedCount = unsolved;
+		heavyCount = heavy;
+		rejectedCount = rejected;
+		exhaustedCount = exhausted;
+		totalSeconds = seconds(tpBegin, clock::now());
+		return outputGood && variantGood;
+	}
+
+	/// <summary>
+	/// judge if the last run wrote all the output
+	/// </summary>
+	/// <returns>if written, false such as the disk is full</returns>
+	bool SolvePipeline::isOutputGood() const
+	{
+		return outputGood;
+	}
+
+	/// <summary>
+	/// judge if the rules of variant fit the sudokus of the last run, such as the cages are in the form
+	/// </summary>
+	/// <returns>if fit, true without a variant</returns>
+	bool SolvePipeline::isVariantGood() const
+	{
+		return variantGood;
+	}
+
+	/// <summary>
+	/// print the throughput of every stage
+	/// </summary>
+	/// <param name="file">file to print</param>
+	void SolvePipeline::printReport(FILE* file) const
+	{
+		struct Row {
+			const char* name;
+			const StageStats* stats;
+		};
+		const Row rows[] = { {"reader", &readerStats}, {"solver", &solverStats}, {"writer", &writerStats} };
+
+		// the rate is the count per second when the stage is busy,
+		// the stage with lowest rate is the bottleneck
+		const char* bound = "none";
+		double lowest = 0;
+		fprintf(file, "%-8s %8s %12s %10s %10s %12s\n", "stage", "threads", "items", "busy(s)", "wait(s)", "rate(/s)");
+		for (auto& row : rows) {
+			double busy = row.stats->busy / row.stats->threads;
+			double rate = busy > 0 ? row.stats->items / busy : 0;
+			fprintf(file, "%-8s %8u %12llu %10.3f %10.3f %12.0f\n", row.name, row.stats->threads,
+				row.stats->items, row.stats->busy, row.stats->wait, rate);
+			if (rate > 0 && (lowest == 0 || rate < lowest)) {
+				lowest = rate;
+				bound = row.name;
+			}
+		}
+		fprintf(file, "total %llu sudokus in %.3f s (%.0f /s), %zu bad, %zu no solution, %zu over limits, bound by %s\n",
+			writerStats.items, totalSeconds, totalSeconds > 0 ? writerStats.items / totalSeconds : 0.0,
+			badCount, unsolvedCount, exhaustedCount, bound);
+		if (validation) fprintf(file, "%zu sudokus rejected by the validation (counted as no solution)\n", rejectedCount);
+		if (heavyNodes > 0) fprintf(file, "%zu sudokus whose tree is estimated over %.0f nodes, solved as heavy\n", heavyCount, heavyNodes);
+	}
+
+	/// <summary>
+	/// get the statistics of reader
+	/// </summary>
+	/// <returns>statistics</returns>
+	const SolvePipeline::StageStats& SolvePipeline::getReaderStats() const
+	{
+		return readerStats;
+	}
+
+	/// <summary>
+	/// get the statistics of solvers
+	/// </summary>
+	/// <returns>statistics</returns>
+	const SolvePipeline::StageStats& SolvePipeline::getSolverStats() const
+	{
+		return solverStats;
+	}
+
+	/// <summary>
+	/// get the statistics of writer
+	/// </summary>
+	/// <returns>statistics</returns>
+	const SolvePipeline::StageStats& SolvePipeline::getWriterStats() const
+	{
+		return writerStats;
+	}
+
+	/// <summary>
+	/// get the seconds of the run
+	/// </summary>
+	/// <returns>seconds</returns>
+	double SolvePipeline::getTotalSeconds() const
+	{
+		return totalSeconds;
+	}
+
+	/// <summary>
+	/// get the count of bad sudokus skipped
+	/// </summary>
+	/// <returns>count</returns>
+	size_t SolvePipeline::getBadCount() const
+	{
+		return badCount;
+	}
+
+	/// <summary>
+	/// get the count of sudokus without solution
+	/// </summary>
+	/// <returns>count</returns>
+	size_t SolvePipeline::getUnsolvedCount() const
+	{
+		return unsolvedCount;
+	}
+
+	/// <summary>
+	/// get the count of sudokus stopped by the limits
+	/// </summary>
+	/// <returns>count</returns>
+	size_t SolvePipeline::getExhaustedCount() const
+	{
+		return exhaustedCount;
+	}
+
+	/// <summary>
+	/// get the count of sudokus solved by the heavy options
+	/// </summary>
+	/// <returns>count</returns>
+	size_t SolvePipeline::getHeavyCount() const
+	{
+		return heavyCount;
+	}
+
+	/// <summary>
+	/// get the count of sudokus rejected by the validation
+	/// </summary>
+	/// <returns>count</returns>
+	size_t SolvePipeline::getRejectedCount() const
+	{
+		return rejectedCount;
+	}
+}
@@ -0,0 +1,205 @@
+﻿// Code By YYYCZ
+
+#ifndef __YYYCZ_SUDOKU_PIPELINE_H__
+#define __YYYCZ_SUDOKU_PIPELINE_H__
+
+#include "FastSudoku.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace YYYCZ {
+	class SolutionCache;
+
+	// a bounded lock-free queue for multi producers and multi consumers.
+	// push waits when full and pop waits when empty, so it gives the backpressure
+	template<typename T>
+	class BoundedQueue {
+		struct Cell {
+			std::atomic<size_t> sequence{ 0 };
+			T data;
+		};
+
+		std::unique_ptr<Cell[]> cells; // the ring buffer
+		size_t mask = 0; // capacity - 1
+		alignas(64) std::atomic<size_t> enqueuePos{ 0 }; // position to push
+		alignas(64) std::atomic<size_t> dequeuePos{ 0 }; // position to pop
+		alignas(64) std::atomic<bool> closed{ false }; // if no more push
+
+		// wait a moment when the queue is full or empty
+		static void backoff(unsigned int& times)
+		{
+			if (++times < 64) return;
+			if (times < 128) std::this_thread::yield();
+			else std::this_thread::sleep_for(std::chrono::microseconds(50));
+		}
+
+	public:
+		BoundedQueue(size_t capacity)
+		{
+			size_t size = 2;
+			while (size < capacity) size <<= 1;
+			cells.reset(new Cell[size]);
+			mask = size - 1;
+			for (size_t i = 0; i < size; ++i) {
+				cells[i].sequence.store(i, std::memory_order_relaxed);
+			}
+		}
+
+		// try to push, return false if full
+		bool tryPush(T& value)
+		{
+			size_t pos = enqueuePos.load(std::memory_order_relaxed);
+			while (true) {
+				Cell& cell = cells[pos & mask];
+				size_t seq = cell.sequence.load(std::memory_order_acquire);
+				intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+				if (diff == 0) {
+					if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+						cell.data = std::move(value);
+						cell.sequence.store(pos + 1, std::memory_order_release);
+						return true;
+					}
+				}
+				else if (diff < 0) {
+					return false;
+				}
+				else {
+					pos = enqueuePos.load(std::memory_order_relaxed);
+				}
+			}
+		}
+
+		// try to pop, return false if empty
+		bool tryPop(T& value)
+		{
+			size_t pos = dequeuePos.load(std::memory_order_relaxed);
+			while (true) {
+				Cell& cell = cells[pos & mask];
+				size_t seq = cell.sequence.load(std::memory_order_acquire);
+				intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+				if (diff == 0) {
+					if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+						value = std::move(cell.data);
+						cell.sequence.store(pos + mask + 1, std::memory_order_release);
+						return true;
+					}
+				}
+				else if (diff < 0) {
+					return false;
+				}
+				else {
+					pos = dequeuePos.load(std::memory_order_relaxed);
+				}
+			}
+		}
+
+		// push and wait if full, return false if closed
+		bool push(T& value)
+		{
+			unsigned int times = 0;
+			while (!tryPush(value)) {
+				if (closed.load(std::memory_order_acquire)) return false;
+				backoff(times);
+			}
+			return true;
+		}
+
+		// pop and wait if empty, return false if closed and empty
+		bool pop(T& value)
+		{
+			unsigned int times = 0;
+			while (!tryPop(value)) {
+				if (closed.load(std::memory_order_acquire)) return tryPop(value);
+				backoff(times);
+			}
+			return true;
+		}
+
+		// no more push
+		void close()
+		{
+			closed.store(true, std::memory_order_release);
+		}
+	};
+
+	// solve the sudokus of a big file in three stages:
+	// reader -> solvers -> writer, connected by bounded queues,
+	// so the memory is constant and the reading and writing overlap with solving
+	class SolvePipeline {
+	public:
+		using save_t = FastSudoku::save_t;
+		using index_t = FastSudoku::index_t;
+
+		// the statistics of one stage
+		struct StageStats {
+			unsigned long long items = 0; // count of sudokus
+			double busy = 0; // seconds of working (sum of all threads)
+			double wait = 0; // seconds of waiting the queues (sum of all threads)
+			index_t threads = 1; // count of threads
+		};
+
+	private:
+		// a chunk of sudokus in the queue
+		struct Chunk {
+			size_t sequence = 0; // the order in the input
+			std::vector<std::vector<save_t>> forms;
+			std::string alphabets; // the alphabet of every form read from text, empty for the corpus
+		};
+
+		index_t workerCount = 0; // count of solvers, 0 for hardware concurrency
+		index_t queueSize = 64; // count of chunks in one queue
+		index_t chunkSize = 64; // count of sudokus in one chunk
+		char outputFormat = 0; // format of output
+		bool corpusOutput = false; // if write a binary corpus
+		SolutionCache* solutionCache = nullptr; // the cache of solutions, null if not use
+		FastSudoku::SolveOptions solveOptions; // the options of every solving, such as the limits
+		bool validation = true; // check the sudokus by the singles before solving
+		double heavyNodes = 0; // the sudokus whose search tree is estimated more nodes are solved by the heavy options, 0 for no estimate
+		FastSudoku::SolveOptions heavyOptions; // the options of the heavy sudokus, such as another backend
+		FastSudoku::EstimateOptions estimateOptions; // the probes of estimating
+
+		StageStats readerStats; // statistics of reader
+		StageStats solverStats; // statistics of solvers
+		StageStats writerStats; // statistics of writer
+		double totalSeconds = 0; // seconds of the run
+		size_t badCount = 0; // count of bad sudokus skipped
+		size_t unsolvedCount = 0; // count of sudokus without solution
+		size_t exhaustedCount = 0; // count of sudokus stopped by the limits
+		size_t heavyCount = 0; // count of sudokus solved by the heavy options
+		size_t rejectedCount = 0; // count of sudokus thrown away by the validation
+		bool outputGood = true; // if all the output is written
+		bool variantGood = true; // if the rules of variant fit the sudokus read
+
+	public:
+		SolvePipeline& setWorkerCount(index_t count);
+		SolvePipeline& setQueueSize(index_t size);
+		SolvePipeline& setChunkSize(index_t size);
+		SolvePipeline& setOutputFormat(char format);
+		SolvePipeline& setCorpusOutput(bool flag);
+		SolvePipeline& setSolutionCache(SolutionCache* cache);
+		SolvePipeline& setSolveOptions(const FastSudoku::SolveOptions& options); // the deadline of options is for every sudoku
+		SolvePipeline& setValidation(bool flag);
+		SolvePipeline& setHeavyRoute(double nodes, const FastSudoku::SolveOptions& options, index_t probes = 16); // 0 nodes for no route
+
+		bool run(const std::string& input, const std::string& output); // "-" for stdin or stdout, the input can be a corpus
+		bool isOutputGood() const; // false if run failed to write the output, such as the disk is full
+		bool isVariantGood() const; // false if run stopped at a sudoku the rules of variant don't fit
+		void printReport(FILE* file = stderr) const;
+
+		const StageStats& getReaderStats() const;
+		const StageStats& getSolverStats() const;
+		const StageStats& getWriterStats() const;
+		double getTotalSeconds() const;
+		size_t getBadCount() const;
+		size_t getUnsolvedCount() const;
+		size_t getExhaustedCount() const;
+		size_t getHeavyCount() const;
+		size_t getRejectedCount() const;
+	};
+}
+
+#endif
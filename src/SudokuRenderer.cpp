@@ -0,0 +1,198 @@
+﻿// Code By YYYCZ
+
+#include "SudokuRenderer.h"
+#include "SudokuHeader.h"
+#include <algorithm>
+
+namespace YYYCZ {
+	/// <summary>
+	/// append one char
+	/// </summary>
+	/// <param name="ch">char</param>
+	/// <returns>the char</returns>
+	FrameRenderer::FrameBuffer::int_type FrameRenderer::FrameBuffer::overflow(int_type ch)
+	{
+		if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+			text.push_back(traits_type::to_char_type(ch));
+		}
+		return traits_type::not_eof(ch);
+	}
+
+	/// <summary>
+	/// append chars
+	/// </summary>
+	/// <param name="s">chars</param>
+	/// <param name="count">count of chars</param>
+	/// <returns>count of chars</returns>
+	std::streamsize FrameRenderer::FrameBuffer::xsputn(const char* s, std::streamsize count)
+	{
+		text.append(s, (size_t)count);
+		return count;
+	}
+
+	/// <summary>
+	/// create a renderer
+	/// </summary>
+	/// <param name="reserveSize">the size reserved for the buffers</param>
+	FrameRenderer::FrameRenderer(size_t reserveSize)
+	{
+		text.reserve(reserveSize);
+		output.reserve(reserveSize);
+	}
+
+	/// <summary>
+	/// begin a frame
+	/// </summary>
+	/// <returns>the stream to print the frame</returns>
+	std::ostream& FrameRenderer::beginFrame()
+	{
+		text.clear();
+		out.clear();
+		return out;
+	}
+
+	/// <summary>
+	/// parse the text of frame into cells, only the colors (SGR) of escape sequences are kept
+	/// </summary>
+	void FrameRenderer::parse()
+	{
+		for (auto& line : cells) line.clear();
+		size_t row = 0, column = 0;
+		cell_t foreground = 0, background = 0, bold = 0;
+
+		auto put = [&](char ch) {
+			if (cells.size() <= row) cells.resize(row + 1);
+			auto& line = cells[row];
+			if (line.size() <= column) line.resize(column + 1, blankCell);
+			line[column++] = (cell_t)(unsigned char)ch | foreground << 8 | background << 16 | bold << 24;
+		};
+
+		for (size_t i = 0; i < text.size(); ++i) {
+			char ch = text[i];
+			if (ch == '\n') {
+				++row;
+				column = 0;
+			}
+			else if (ch == '\r') {
+				column = 0;
+			}
+			else if (ch == '\t') {
+				size_t next = (column / 8 + 1) * 8;
+				while (column < next) put(' ');
+			}
+			else if (ch == '\033' && i + 1 < text.size() && text[i + 1] == '[') {
+				// the parameters until the final byte
+				size_t end = i + 2;
+				while (end < text.size() && !(text[end] >= '@' && text[end] <= '~')) ++end;
+				if (end < text.size() && text[end] == 'm') {
+					size_t p = i + 2;
+					do {
+						unsigned int code = 0;
+						while (p < end && text[p] >= '0' && text[p] <= '9') code = code * 10 + (text[p++] - '0');
+						if (code == 0) foreground = background = bold = 0;
+						else if (code == 1) bold = 1;
+						else if (code == 22) bold = 0;
+						else if ((code >= 30 && code <= 37) || (code >= 90 && code <= 97)) foreground = code;
+						else if (code == 39) foreground = 0;
+						else if ((code >= 40 && code <= 47) || (code >= 100 && code <= 107)) background = code;
+						else if (code == 49) background = 0;
+					} while (p++ < end);
+				}
+				i = end;
+			}
+			else if ((unsigned char)ch >= ' ') {
+				put(ch);
+			}
+		}
+		cells.resize(std::max(cells.size(), row + (column ? 1 : 0)));
+	}
+
+	/// <summary>
+	/// make the output from the cells changed
+	/// </summary>
+	void FrameRenderer::diff()
+	{
+		output.clear();
+		if (invalid) {
+			output += "\033[0m\033[2J";
+			for (auto& line : lastCells) line.clear();
+			invalid = false;
+		}
+
+		const size_t rows = std::max(cells.size(), lastCells.size());
+		cells.resize(rows);
+		lastCells.resize(rows);
+
+		size_t cursorRow = (size_t)-1, cursorColumn = 0;
+		cell_t attribute = (cell_t)-1; // unknown
+		auto write = [&](cell_t cell) {
+			cell_t cellAttribute = cell >> 8;
+			if (cellAttribute != attribute) {
+				output += "\033[0";
+				if (cellAttribute >> 16) output += ";1";
+				if (cellAttribute & 0xFF) (output += ';') += std::to_string(cellAttribute & 0xFF);
+				if ((cellAttribute >> 8) & 0xFF) (output += ';') += std::to_string((cellAttribute >> 8) & 0xFF);
+				output += 'm';
+				attribute = cellAttribute;
+			}
+			output += (char)(cell & 0xFF);
+			++cursorColumn;
+		};
+		auto emit = [&](size_t row, size_t column, cell_t cell) {
+			// move the cursor, or rewrite the short gap which is cheaper
+			if (row != cursorRow || column < cursorColumn || column - cursorColumn > 4) {
+				output += "\033[";
+				output += std::to_string(row + 1);
+				output += ';';
+				output += std::to_string(column + 1);
+				output += 'H';
+				cursorRow = row;
+				cursorColumn = column;
+			}
+			while (cursorColumn < column) {
+				write(cursorColumn < cells[row].size() ? cells[row][cursorColumn] : blankCell);
+			}
+			write(cell);
+		};
+
+		for (size_t row = 0; row < rows; ++row) {
+			auto& line = cells[row];
+			auto& lastLine = lastCells[row];
+			const size_t columns = std::max(line.size(), lastLine.size());
+			for (size_t column = 0; column < columns; ++column) {
+				cell_t cell = column < line.size() ? line[column] : blankCell;
+				cell_t lastCell = column < lastLine.size() ? lastLine[column] : blankCell;
+				if (cell != lastCell) emit(row, column, cell);
+			}
+		}
+
+		// leave the cursor under the frame, so other outputs won't break the frame
+		if (!output.empty()) {
+			output += "\033[0m\033[";
+			output += std::to_string(rows + 1);
+			output += ";1H";
+		}
+		std::swap(cells, lastCells);
+	}
+
+	/// <summary>
+	/// end the frame, and write the changes on the console
+	/// </summary>
+	/// <returns>the bytes written</returns>
+	size_t FrameRenderer::endFrame()
+	{
+		out.flush();
+		parse();
+		diff();
+		if (!output.empty()) writeConsole(output.data(), output.size());
+		return output.size();
+	}
+
+	/// <summary>
+	/// clear the console and redraw everything in the next frame
+	/// </summary>
+	void FrameRenderer::invalidate()
+	{
+		invalid = true;
+	}
+}
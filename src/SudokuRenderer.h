@@ -0,0 +1,53 @@
+﻿// Code By YYYCZ
+
+#ifndef __YYYCZ_SUDOKU_RENDERER_H__
+#define __YYYCZ_SUDOKU_RENDERER_H__
+
+#include <cstdint>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace YYYCZ {
+	// draw the frames on the console without flicker:
+	// a frame is printed into a buffer (the ANSI colors are kept), parsed into a grid of cells,
+	// and only the cells different from the last frame are written, by one write call
+	class FrameRenderer {
+		// the stream buffer appending to a string, not flush anything
+		class FrameBuffer : public std::streambuf {
+			std::string& text;
+
+		protected:
+			int_type overflow(int_type ch) override;
+			std::streamsize xsputn(const char* s, std::streamsize count) override;
+
+		public:
+			FrameBuffer(std::string& text) : text(text) {}
+		};
+
+		// a cell is the char | foreground << 8 | background << 16 | bold << 24
+		using cell_t = uint32_t;
+		static constexpr cell_t blankCell = ' ';
+
+		std::string text; // the text of now frame
+		FrameBuffer buffer{ text };
+		std::ostream out{ &buffer };
+		std::vector<std::vector<cell_t>> cells; // cells of now frame
+		std::vector<std::vector<cell_t>> lastCells; // cells on the console
+		std::string output; // the bytes to write
+		bool invalid = true; // if the console need to clear
+
+		void parse();
+		void diff();
+
+	public:
+		FrameRenderer(size_t reserveSize = 1 << 16);
+
+		std::ostream& beginFrame(); // begin a frame, and print it into the stream
+		size_t endFrame(); // write the changes on the console, return the bytes written
+		void invalidate(); // clear the console and redraw everything in the next frame
+	};
+}
+
+#endif
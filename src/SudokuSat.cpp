@@ -0,0 +1,812 @@
+﻿// Code By YYYCZ
+
+#include "SudokuSat.h"
+#include <algorithm>
+#include <cmath>
+#include <ostream>
+
+namespace YYYCZ {
+	/// <summary>
+	/// make a variable
+	/// </summary>
+	/// <param name="place">the place, size for the counters</param>
+	/// <param name="number">the number, 0 for the counters</param>
+	/// <returns>the literal of variable</returns>
+	SudokuCnf::literal_t SudokuCnf::newVariable(index_t place, save_t number)
+	{
+		meanings.emplace_back(place, number);
+		return (literal_t)meanings.size() - 1;
+	}
+
+	/// <summary>
+	/// add a clause
+	/// </summary>
+	/// <param name="literals">the literals, empty clause can't be satisfied</param>
+	void SudokuCnf::addClause(std::initializer_list<literal_t> literals)
+	{
+		clauses.insert(clauses.end(), literals.begin(), literals.end());
+		clauses.push_back(0);
+		++clauseCount;
+	}
+
+	/// <summary>
+	/// add the clauses of exactly one literal is true.
+	/// at most one is the pairs for the short lists, and the sequential counter for the long ones:
+	/// counter i is true if one of the first i + 1 literals is true
+	/// </summary>
+	/// <param name="literals">the literals</param>
+	void SudokuCnf::addExactlyOne(const std::vector<literal_t>& literals)
+	{
+		// at least one
+		clauses.insert(clauses.end(), literals.begin(), literals.end());
+		clauses.push_back(0);
+		++clauseCount;
+
+		const size_t count = literals.size();
+		if (count <= 5) {
+			for (size_t i = 0; i < count; ++i) {
+				for (size_t j = i + 1; j < count; ++j) {
+					addClause({ -literals[i], -literals[j] });
+				}
+			}
+			return;
+		}
+
+		literal_t counter = newVariable(formSize, 0);
+		addClause({ -literals[0], counter });
+		for (size_t i = 1; i + 1 < count; ++i) {
+			literal_t next = newVariable(formSize, 0);
+			addClause({ -literals[i], next });
+			addClause({ -counter, next });
+			addClause({ -literals[i], -counter });
+			counter = next;
+		}
+		addClause({ -literals[count - 1], -counter });
+	}
+
+	/// <summary>
+	/// encode the sudoku, the numbers conflicting with the givens have no variable
+	/// </summary>
+	/// <param name="form">the sudoku form</param>
+	/// <param name="geometry">the blocks, null for the standard boxes of the size</param>
+	/// <returns>false if the size of form is not a sudoku of the blocks</returns>
+	bool SudokuCnf::encode(const std::vector<save_t>& form, const SudokuGeometry* geometry)
+	{
+		formLength = formSize = 0;
+		this->form.clear();
+		variables.clear();
+		meanings.assign(1, std::make_pair(0u, 0));
+		clauses.clear();
+		clauseCount = 0;
+
+		// only the form fitting the blocks
+		auto standard = geometry ? nullptr : SudokuGeometry::standard(form.size());
+		if (!geometry) geometry = standard.get();
+		if (form.empty() || !geometry || geometry->getSize() != form.size()) {
+			return false;
+		}
+		formLength = geometry->getLength();
+		formSize = geometry->getSize();
+
+		// the numbers used by the rows, columns and blocks
+		const index_t length = formLength;
+		std::vector<char> used(3 * length * (length + 1), 0);
+		auto unitsOf = [&](index_t place, index_t units[3]) {
+			const index_t row = place / length, column = place % length;
+			units[0] = row;
+			units[1] = length + column;
+			units[2] = 2 * length + geometry->blockOf(place);
+		};
+
+		this->form.assign(form.begin(), form.end());
+		bool conflict = false;
+		for (index_t place = 0; place < formSize; ++place) {
+			save_t& number = this->form[place];
+			if (number <= 0 || (index_t)number > length) {
+				number = 0;
+				continue;
+			}
+			index_t units[3];
+			unitsOf(place, units);
+			for (index_t unit : units) {
+				char& mark = used[unit * (length + 1) + number];
+				if (mark) conflict = true;
+				mark = 1;
+			}
+		}
+		if (conflict) {
+			// the same number twice in a unit
+			addClause({});
+			return true;
+		}
+
+		// the variables of the blank places
+		variables.assign((size_t)formSize * length, 0);
+		for (index_t place = 0; place < formSize; ++place) {
+			if (this->form[place]) continue;
+			index_t units[3];
+			unitsOf(place, units);
+			for (save_t number = 1; (index_t)number <= length; ++number) {
+				if (used[units[0] * (length + 1) + number] || used[units[1] * (length + 1) + number]
+					|| used[units[2] * (length + 1) + number]) continue;
+				variables[(size_t)place * length + number - 1] = (index_t)newVariable(place, number);
+			}
+		}
+
+		// one number a place
+		std::vector<literal_t> literals;
+		for (index_t place = 0; place < formSize; ++place) {
+			if (this->form[place]) continue;
+			literals.clear();
+			for (save_t number = 1; (index_t)number <= length; ++number) {
+				if (literal_t literal = literalOf(place, number)) literals.push_back(literal);
+			}
+			addExactlyOne(literals);
+		}
+
+		// one place a number of every unit
+		for (index_t unit = 0; unit < 3 * length; ++unit) {
+			for (save_t number = 1; (index_t)number <= length; ++number) {
+				if (used[unit * (length + 1) + number]) continue;
+				literals.clear();
+				for (index_t i = 0; i < length; ++i) {
+					index_t place;
+					if (unit < length) place = unit * length + i;
+					else if (unit < 2 * length) place = i * length + unit - length;
+					else place = geometry->placeOf(unit - 2 * length, i);
+					if (literal_t literal = literalOf(place, number)) literals.push_back(literal);
+				}
+				addExactlyOne(literals);
+			}
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// get the count of variables
+	/// </summary>
+	/// <returns>count</returns>
+	SudokuCnf::index_t SudokuCnf::getVariableCount() const
+	{
+		return (index_t)meanings.size() - 1;
+	}
+
+	/// <summary>
+	/// get the count of clauses
+	/// </summary>
+	/// <returns>count</returns>
+	SudokuCnf::index_t SudokuCnf::getClauseCount() const
+	{
+		return clauseCount;
+	}
+
+	/// <summary>
+	/// get the clauses, every clause ends with 0
+	/// </summary>
+	/// <returns>the literals of clauses</returns>
+	const std::vector<SudokuCnf::literal_t>& SudokuCnf::getClauses() const
+	{
+		return clauses;
+	}
+
+	/// <summary>
+	/// get the literal of the number filled in the place
+	/// </summary>
+	/// <param name="place">the place</param>
+	/// <param name="number">the number</param>
+	/// <returns>the literal, 0 if the number can't be filled</returns>
+	SudokuCnf::literal_t SudokuCnf::literalOf(index_t place, save_t number) const
+	{
+		if (place >= formSize || number <= 0 || (index_t)number > formLength || variables.empty()) return 0;
+		return (literal_t)variables[(size_t)place * formLength + number - 1];
+	}
+
+	/// <summary>
+	/// get the solution from the model
+	/// </summary>
+	/// <param name="model">model[v] for variable v</param>
+	/// <param name="solution">the solution</param>
+	/// <returns>false if a place has no number or more than one</returns>
+	bool SudokuCnf::decode(const std::vector<bool>& model, std::vector<save_t>& solution) const
+	{
+		solution = form;
+		if (model.size() < meanings.size() || variables.empty()) {
+			solution.clear();
+			return false;
+		}
+		for (index_t v = 1; v < meanings.size(); ++v) {
+			if (!model[v] || meanings[v].second == 0) continue;
+			save_t& number = solution[meanings[v].first];
+			if (number) {
+				solution.clear();
+				return false;
+			}
+			number = meanings[v].second;
+		}
+		for (auto number : solution) {
+			if (number == 0) {
+				solution.clear();
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// write the clauses as DIMACS, the variables of numbers are in the comments as "c v row column number"
+	/// </summary>
+	/// <param name="out">the stream</param>
+	void SudokuCnf::writeDimacs(std::ostream& out) const
+	{
+		out << "c sudoku " << formLength << "x" << formLength << "\n";
+		for (index_t v = 1; v < meanings.size(); ++v) {
+			if (meanings[v].second == 0) continue;
+			out << "c " << v << " " << meanings[v].first / formLength + 1 << " "
+				<< meanings[v].first % formLength + 1 << " " << meanings[v].second << "\n";
+		}
+		out << "p cnf " << getVariableCount() << " " << clauseCount << "\n";
+		bool begin = true;
+		for (literal_t literal : clauses) {
+			if (!begin) out << ' ';
+			out << literal;
+			begin = literal == 0;
+			if (begin) out << '\n';
+		}
+	}
+
+	/// <summary>
+	/// get the value of literal
+	/// </summary>
+	/// <param name="literal">the literal</param>
+	/// <returns>the value</returns>
+	inline signed char SatSolver::valueOf(lit_t literal) const
+	{
+		const signed char value = values[literal >> 1];
+		return value == valueUnknown ? valueUnknown : value ^ (signed char)(literal & 1);
+	}
+
+	/// <summary>
+	/// make the literal true
+	/// </summary>
+	/// <param name="literal">the literal</param>
+	/// <param name="reason">the clause implying it, noClause for decision</param>
+	inline void SatSolver::enqueue(lit_t literal, index_t reason)
+	{
+		const index_t variable = literal >> 1;
+		values[variable] = (literal & 1) ? valueFalse : valueTrue;
+		levels[variable] = decisionLevel();
+		reasons[variable] = reason;
+		trail.push_back(literal);
+	}
+
+	/// <summary>
+	/// add a clause of two literals at least, and watch the first two
+	/// </summary>
+	/// <param name="literals">the literals</param>
+	/// <param name="learned">if learned</param>
+	/// <returns>the clause</returns>
+	SatSolver::index_t SatSolver::addClause(const std::vector<lit_t>& literals, bool learned)
+	{
+		index_t index;
+		if (!freeClauses.empty()) {
+			index = freeClauses.back();
+			freeClauses.pop_back();
+		}
+		else {
+			index = (index_t)clauses.size();
+			clauses.emplace_back();
+		}
+		Clause& clause = clauses[index];
+		clause.literals = literals;
+		clause.learned = learned;
+		clause.removed = false;
+		clause.activity = 0;
+		watches[literals[0]].push_back({ index, literals[1] });
+		watches[literals[1]].push_back({ index, literals[0] });
+		return index;
+	}
+
+	/// <summary>
+	/// propagate the literals assigned by the watches
+	/// </summary>
+	/// <returns>the clause conflicting, noClause if no conflict</returns>
+	SatSolver::index_t SatSolver::propagate()
+	{
+		while (propagated < trail.size()) {
+			const lit_t falseLiteral = trail[propagated++] ^ 1;
+			auto& list = watches[falseLiteral];
+			size_t i = 0, j = 0;
+			while (i < list.size()) {
+				const Watch watch = list[i++];
+				if (valueOf(watch.blocker) == valueTrue) {
+					list[j++] = watch;
+					continue;
+				}
+
+				// the false literal is the second one
+				auto& literals = clauses[watch.clause].literals;
+				if (literals[0] == falseLiteral) std::swap(literals[0], literals[1]);
+				const lit_t first = literals[0];
+				if (first != watch.blocker && valueOf(first) == valueTrue) {
+					list[j++] = { watch.clause, first };
+					continue;
+				}
+
+				// watch another literal not false
+				bool moved = false;
+				for (size_t k = 2; k < literals.size(); ++k) {
+					if (valueOf(literals[k]) != valueFalse) {
+						std::swap(literals[1], literals[k]);
+						watches[literals[1]].push_back({ watch.clause, first });
+						moved = true;
+						break;
+					}
+				}
+				if (moved) continue;
+
+				// unit or conflict
+				list[j++] = { watch.clause, first };
+				if (valueOf(first) == valueFalse) {
+					while (i < list.size()) list[j++] = list[i++];
+					list.resize(j);
+					propagated = (index_t)trail.size();
+					return watch.clause;
+				}
+				enqueue(first, watch.clause);
+			}
+			list.resize(j);
+		}
+		return noClause;
+	}
+
+	/// <summary>
+	/// judge if the literal of learned clause is implied by the others
+	/// </summary>
+	/// <param name="literal">the literal</param>
+	/// <returns>if redundant</returns>
+	bool SatSolver::isRedundant(lit_t literal) const
+	{
+		const index_t reason = reasons[literal >> 1];
+		if (reason == noClause) return false;
+		const auto& literals = clauses[reason].literals;
+		for (size_t k = 1; k < literals.size(); ++k) {
+			const index_t variable = literals[k] >> 1;
+			if (!seen[variable] && levels[variable] > 0) return false;
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// learn the first UIP clause of the conflict, the literal asserted is the first one
+	/// </summary>
+	/// <param name="conflict">the clause conflicting</param>
+	/// <param name="backLevel">the level to jump back</param>
+	void SatSolver::analyze(index_t conflict, index_t& backLevel)
+	{
+		learnt.assign(1, noLiteral);
+		toClear.clear();
+		index_t paths = 0;
+		lit_t literal = noLiteral;
+		size_t index = trail.size();
+		index_t reason = conflict;
+
+		do {
+			Clause& clause = clauses[reason];
+			if (clause.learned) bumpClause(clause);
+			for (size_t k = literal == noLiteral ? 0 : 1; k < clause.literals.size(); ++k) {
+				const lit_t q = clause.literals[k];
+				const index_t variable = q >> 1;
+				if (seen[variable] || levels[variable] == 0) continue;
+				seen[variable] = 1;
+				toClear.push_back(q);
+				bumpVariable(variable);
+				if (levels[variable] >= decisionLevel()) ++paths;
+				else learnt.push_back(q);
+			}
+
+			// the next literal seen on the trail
+			while (!seen[trail[--index] >> 1]);
+			literal = trail[index];
+			reason = reasons[literal >> 1];
+			seen[literal >> 1] = 0;
+			--paths;
+		} while (paths > 0);
+		learnt[0] = literal ^ 1;
+
+		// drop the literals implied by the others
+		size_t kept = 1;
+		for (size_t k = 1; k < learnt.size(); ++k) {
+			if (!isRedundant(learnt[k])) learnt[kept++] = learnt[k];
+		}
+		learnt.resize(kept);
+		for (lit_t q : toClear) seen[q >> 1] = 0;
+
+		// the second literal is of the highest level
+		backLevel = 0;
+		for (size_t k = 1; k < learnt.size(); ++k) {
+			if (levels[learnt[k] >> 1] > backLevel) {
+				backLevel = levels[learnt[k] >> 1];
+				std::swap(learnt[1], learnt[k]);
+			}
+		}
+	}
+
+	/// <summary>
+	/// undo the assignments over the level
+	/// </summary>
+	/// <param name="level">the level</param>
+	void SatSolver::backtrack(index_t level)
+	{
+		if (decisionLevel() <= level) return;
+		for (size_t k = trail.size(); k > trailLimits[level]; --k) {
+			const index_t variable = trail[k - 1] >> 1;
+			phases[variable] = values[variable];
+			values[variable] = valueUnknown;
+			reasons[variable] = noClause;
+			heapInsert(variable);
+		}
+		trail.resize(trailLimits[level]);
+		trailLimits.resize(level);
+		propagated = (index_t)trail.size();
+	}
+
+	/// <summary>
+	/// choose the variable of the highest activity, with its last value
+	/// </summary>
+	/// <returns>the literal, noLiteral if all assigned</returns>
+	SatSolver::lit_t SatSolver::pickBranch()
+	{
+		while (!heap.empty()) {
+			const index_t variable = heapPop();
+			if (values[variable] == valueUnknown) {
+				return variable * 2 + (phases[variable] == valueTrue ? 0 : 1);
+			}
+		}
+		return noLiteral;
+	}
+
+	/// <summary>
+	/// judge if the clause is the reason of an assignment
+	/// </summary>
+	/// <param name="clause">the clause</param>
+	/// <returns>if locked</returns>
+	bool SatSolver::isLocked(index_t clause) const
+	{
+		const lit_t first = clauses[clause].literals[0];
+		return valueOf(first) == valueTrue && reasons[first >> 1] == clause;
+	}
+
+	/// <summary>
+	/// remove the half of learned clauses with low activity, the binary and locked ones are kept
+	/// </summary>
+	void SatSolver::reduceLearned()
+	{
+		std::vector<index_t> candidates;
+		for (index_t c = 0; c < clauses.size(); ++c) {
+			const Clause& clause = clauses[c];
+			if (clause.learned && !clause.removed && clause.literals.size() > 2 && !isLocked(c)) candidates.push_back(c);
+		}
+		std::sort(candidates.begin(), candidates.end(), [this](index_t a, index_t b) {
+			return clauses[a].activity < clauses[b].activity;
+		});
+		candidates.resize(candidates.size() / 2);
+		for (index_t c : candidates) {
+			clauses[c].removed = true;
+			clauses[c].literals.clear();
+			freeClauses.push_back(c);
+			--learnedAlive;
+		}
+
+		// the slots may be reused, so no watch of them is left
+		for (auto& list : watches) {
+			list.erase(std::remove_if(list.begin(), list.end(), [this](const Watch& watch) {
+				return clauses[watch.clause].removed;
+			}), list.end());
+		}
+	}
+
+	/// <summary>
+	/// increase the activity of variable
+	/// </summary>
+	/// <param name="variable">the variable</param>
+	void SatSolver::bumpVariable(index_t variable)
+	{
+		if ((activities[variable] += activityIncrease) > 1e100) {
+			for (auto& activity : activities) activity *= 1e-100;
+			activityIncrease *= 1e-100;
+		}
+		if (heapIndex[variable] != noIndex) heapUp(heapIndex[variable]);
+	}
+
+	/// <summary>
+	/// increase the activity of clause
+	/// </summary>
+	/// <param name="clause">the clause</param>
+	void SatSolver::bumpClause(Clause& clause)
+	{
+		if ((clause.activity += clauseIncrease) > 1e20) {
+			for (auto& c : clauses) c.activity *= 1e-20;
+			clauseIncrease *= 1e-20;
+		}
+	}
+
+	/// <summary>
+	/// move the item up the heap
+	/// </summary>
+	/// <param name="i">index of heap</param>
+	void SatSolver::heapUp(index_t i)
+	{
+		const index_t variable = heap[i];
+		while (i > 0) {
+			const index_t parent = (i - 1) / 2;
+			if (activities[heap[parent]] >= activities[variable]) break;
+			heap[i] = heap[parent];
+			heapIndex[heap[i]] = i;
+			i = parent;
+		}
+		heap[i] = variable;
+		heapIndex[variable] = i;
+	}
+
+	/// <summary>
+	/// move the item down the heap
+	/// </summary>
+	/// <param name="i">index of heap</param>
+	void SatSolver::heapDown(index_t i)
+	{
+		const index_t variable = heap[i];
+		const index_t size = (index_t)heap.size();
+		while (2 * i + 1 < size) {
+			index_t child = 2 * i + 1;
+			if (child + 1 < size && activities[heap[child + 1]] > activities[heap[child]]) ++child;
+			if (activities[heap[child]] <= activities[variable]) break;
+			heap[i] = heap[child];
+			heapIndex[heap[i]] = i;
+			i = child;
+		}
+		heap[i] = variable;
+		heapIndex[variable] = i;
+	}
+
+	/// <summary>
+	/// put the variable into the heap if not in it
+	/// </summary>
+	/// <param name="variable">the variable</param>
+	void SatSolver::heapInsert(index_t variable)
+	{
+		if (heapIndex[variable] != noIndex) return;
+		heap.push_back(variable);
+		heapUp((index_t)heap.size() - 1);
+	}
+
+	/// <summary>
+	/// take the variable of the highest activity
+	/// </summary>
+	/// <returns>the variable</returns>
+	SatSolver::index_t SatSolver::heapPop()
+	{
+		const index_t top = heap[0];
+		heapIndex[top] = noIndex;
+		if (heap.size() > 1) {
+			heap[0] = heap.back();
+			heap.pop_back();
+			heapDown(0);
+		}
+		else {
+			heap.pop_back();
+		}
+		return top;
+	}
+
+	/// <summary>
+	/// the Luby sequence: 1, 1, 2, 1, 1, 2, 4, ...
+	/// </summary>
+	/// <param name="i">index from 0</param>
+	/// <returns>the item</returns>
+	SatSolver::index_t SatSolver::luby(index_t i)
+	{
+		index_t size = 1, power = 1;
+		while (size < i + 1) {
+			size = 2 * size + 1;
+			power *= 2;
+		}
+		while (size - 1 != i) {
+			size = (size - 1) / 2;
+			power /= 2;
+			i %= size;
+		}
+		return power;
+	}
+
+	/// <summary>
+	/// load the clauses, the units are assigned without decision
+	/// </summary>
+	/// <param name="variableCount">the count of variables</param>
+	/// <param name="clauses">the literals of clauses, every clause ends with 0</param>
+	/// <returns>SatSolver</returns>
+	SatSolver& SatSolver::load(index_t variableCount, const std::vector<literal_t>& clauses)
+	{
+		this->variableCount = variableCount;
+		unsatisfiable = false;
+		this->clauses.clear();
+		freeClauses.clear();
+		watches.assign((size_t)variableCount * 2, {});
+		values.assign(variableCount, valueUnknown);
+		levels.assign(variableCount, 0);
+		reasons.assign(variableCount, noClause);
+		trail.clear();
+		trailLimits.clear();
+		propagated = 0;
+		phases.assign(variableCount, valueFalse);
+		seen.assign(variableCount, 0);
+		activities.assign(variableCount, 0);
+		activityIncrease = clauseIncrease = 1;
+		heap.clear();
+		heapIndex.assign(variableCount, noIndex);
+		for (index_t v = 0; v < variableCount; ++v) heapInsert(v);
+		model.clear();
+		decisions = conflicts = learnedCount = learnedAlive = backjumps = restarts = 0;
+
+		std::vector<lit_t> literals;
+		for (literal_t literal : clauses) {
+			if (literal != 0) {
+				literals.push_back(toLiteral(literal));
+				continue;
+			}
+
+			// drop the same literals, and the clause always true
+			std::sort(literals.begin(), literals.end());
+			literals.erase(std::unique(literals.begin(), literals.end()), literals.end());
+			bool tautology = false;
+			for (size_t k = 1; k < literals.size(); ++k) {
+				if ((literals[k] ^ 1) == literals[k - 1]) tautology = true;
+			}
+			if (tautology) {
+				literals.clear();
+				continue;
+			}
+			if (literals.empty()) {
+				unsatisfiable = true;
+			}
+			else if (literals.size() == 1) {
+				const signed char value = valueOf(literals[0]);
+				if (value == valueFalse) unsatisfiable = true;
+				else if (value == valueUnknown) enqueue(literals[0], noClause);
+			}
+			else {
+				addClause(literals, false);
+			}
+			literals.clear();
+		}
+		return *this;
+	}
+
+	/// <summary>
+	/// search the model
+	/// </summary>
+	/// <param name="stop">called every decision, true to stop</param>
+	/// <returns>the status</returns>
+	char SatSolver::solve(const StopChecker& stop)
+	{
+		model.clear();
+		if (unsatisfiable || propagate() != noClause) {
+			unsatisfiable = true;
+			return Status_Unsatisfiable;
+		}
+
+		const index_t restartBase = 100;
+		index_t restartLimit = restartBase * luby(0), runConflicts = 0;
+		double maxLearned = std::max(clauses.size() / 3.0, 2000.0);
+
+		while (true) {
+			const index_t conflict = propagate();
+			if (conflict != noClause) {
+				++conflicts;
+				++runConflicts;
+				if (decisionLevel() == 0) {
+					unsatisfiable = true;
+					return Status_Unsatisfiable;
+				}
+
+				index_t backLevel = 0;
+				analyze(conflict, backLevel);
+				if (backLevel + 1 < decisionLevel()) ++backjumps;
+				backtrack(backLevel);
+				if (learnt.size() == 1) {
+					enqueue(learnt[0], noClause);
+				}
+				else {
+					const index_t clause = addClause(learnt, true);
+					bumpClause(clauses[clause]);
+					enqueue(learnt[0], clause);
+					++learnedAlive;
+				}
+				++learnedCount;
+				activityIncrease /= 0.95;
+				clauseIncrease /= 0.999;
+				continue;
+			}
+
+			// restart by the Luby schedule, the saved phases keep the progress
+			if (runConflicts >= restartLimit) {
+				backtrack(0);
+				runConflicts = 0;
+				restartLimit = restartBase * luby(++restarts);
+				continue;
+			}
+			if (learnedAlive >= maxLearned + trail.size()) {
+				reduceLearned();
+				maxLearned *= 1.1;
+			}
+
+			const lit_t literal = pickBranch();
+			if (literal == noLiteral) {
+				model.assign((size_t)variableCount + 1, false);
+				for (index_t v = 0; v < variableCount; ++v) model[v + 1] = values[v] == valueTrue;
+				backtrack(0);
+				return Status_Satisfiable;
+			}
+			++decisions;
+			if (stop && stop(decisions)) {
+				backtrack(0);
+				return Status_Stopped;
+			}
+			trailLimits.push_back((index_t)trail.size());
+			enqueue(literal, noClause);
+		}
+	}
+
+	/// <summary>
+	/// get the model found
+	/// </summary>
+	/// <returns>model[v] for variable v, empty if not satisfiable</returns>
+	const std::vector<bool>& SatSolver::getModel() const
+	{
+		return model;
+	}
+
+	/// <summary>
+	/// get the times of decision
+	/// </summary>
+	/// <returns>times</returns>
+	SatSolver::index_t SatSolver::getDecisions() const
+	{
+		return decisions;
+	}
+
+	/// <summary>
+	/// get the times of conflict
+	/// </summary>
+	/// <returns>times</returns>
+	SatSolver::index_t SatSolver::getConflicts() const
+	{
+		return conflicts;
+	}
+
+	/// <summary>
+	/// get the count of clauses learned
+	/// </summary>
+	/// <returns>count</returns>
+	SatSolver::index_t SatSolver::getLearnedCount() const
+	{
+		return learnedCount;
+	}
+
+	/// <summary>
+	/// get the times of jumping over a level
+	/// </summary>
+	/// <returns>times</returns>
+	SatSolver::index_t SatSolver::getBackjumps() const
+	{
+		return backjumps;
+	}
+
+	/// <summary>
+	/// get the times of restart
+	/// </summary>
+	/// <returns>times</returns>
+	SatSolver::index_t SatSolver::getRestarts() const
+	{
+		return restarts;
+	}
+}
@@ -0,0 +1,153 @@
+﻿// Code By YYYCZ
+
+#ifndef __YYYCZ_SUDOKU_SAT_H__
+#define __YYYCZ_SUDOKU_SAT_H__
+
+#include "FastSudoku.h"
+#include <functional>
+#include <initializer_list>
+#include <iosfwd>
+#include <vector>
+
+namespace YYYCZ {
+	// the sudoku as CNF (and of the clauses, a clause is or of the literals), for the large sudokus.
+	// only the numbers can be filled in the blank places have variables, and every place,
+	// every number of a row, column and block is exactly one of them.
+	// "at most one" of a long list is the sequential counter (3n clauses and n more variables), not n^2 / 2 pairs.
+	// the literals are the same as DIMACS: v for variable v (from 1), -v for not v.
+	// NOT THREAD SAFE
+	class SudokuCnf {
+	public:
+		using save_t = FastSudoku::save_t;
+		using index_t = FastSudoku::index_t;
+		using literal_t = int;
+
+	private:
+		index_t formLength = 0; // the length of the form
+		index_t formSize = 0; // the size of the form
+		std::vector<save_t> form; // the givens
+		std::vector<index_t> variables; // the variable of place * length + number - 1, 0 if the number can't be filled
+		std::vector<std::pair<index_t, save_t>> meanings; // the place and number of a variable, (size, 0) for the counters
+		index_t clauseCount = 0; // the count of clauses
+		std::vector<literal_t> clauses; // the literals of clauses, every clause ends with 0
+
+		literal_t newVariable(index_t place, save_t number);
+		void addClause(std::initializer_list<literal_t> literals);
+		void addExactlyOne(const std::vector<literal_t>& literals);
+
+	public:
+		bool encode(const std::vector<save_t>& form, const SudokuGeometry* geometry = nullptr); // false if the size of form is not a sudoku of the blocks
+		index_t getVariableCount() const;
+		index_t getClauseCount() const;
+		const std::vector<literal_t>& getClauses() const;
+		literal_t literalOf(index_t place, save_t number) const; // 0 if the number can't be filled
+		bool decode(const std::vector<bool>& model, std::vector<save_t>& solution) const; // model[v] for variable v
+		void writeDimacs(std::ostream& out) const; // the meanings of variables are in the comments
+	};
+
+	// a small CDCL (conflict driven clause learning) SAT solver:
+	// two watched literals, learning the first UIP clause, VSIDS to choose the variable,
+	// saved phases, Luby restarts, and the learned clauses reduced by activity.
+	// NOT THREAD SAFE
+	class SatSolver {
+	public:
+		using index_t = FastSudoku::index_t;
+		using literal_t = SudokuCnf::literal_t;
+		using StopChecker = std::function<bool(index_t decisions)>; // called every decision, true to stop
+
+		static constexpr char Status_Satisfiable = 0;
+		static constexpr char Status_Unsatisfiable = 1;
+		static constexpr char Status_Stopped = 2; // stopped by the checker
+
+	private:
+		using lit_t = unsigned int; // variable * 2, +1 for not
+
+		static constexpr index_t noClause = ~0u;
+		static constexpr index_t noIndex = ~0u; // not in the heap
+		static constexpr lit_t noLiteral = ~0u;
+		static constexpr signed char valueFalse = 0;
+		static constexpr signed char valueTrue = 1;
+		static constexpr signed char valueUnknown = 2;
+
+		// a clause, the first two literals are watched
+		struct Clause {
+			std::vector<lit_t> literals;
+			bool learned = false;
+			bool removed = false;
+			double activity = 0;
+		};
+
+		// a clause watching the literal, skip it if the blocker is true
+		struct Watch {
+			index_t clause;
+			lit_t blocker;
+		};
+
+		index_t variableCount = 0; // the count of variables
+		bool unsatisfiable = false; // if a conflict without decision is found
+		std::vector<Clause> clauses; // the clauses
+		std::vector<index_t> freeClauses; // the slots of clauses removed
+		std::vector<std::vector<Watch>> watches; // the clauses watching a literal, checked when it is false
+		std::vector<signed char> values; // the value of variables
+		std::vector<index_t> levels; // the decision level of variables
+		std::vector<index_t> reasons; // the clause implying the variables, noClause for decisions
+		std::vector<lit_t> trail; // the literals assigned in order
+		std::vector<index_t> trailLimits; // the size of trail before every decision
+		index_t propagated = 0; // the literals of trail propagated
+		std::vector<signed char> phases; // the last value of variables
+		std::vector<char> seen; // for analysis
+		std::vector<lit_t> learnt; // the clause learned
+		std::vector<lit_t> toClear; // the literals seen in analysis
+
+		// VSIDS, a max heap of variables by activity
+		std::vector<double> activities;
+		double activityIncrease = 1;
+		double clauseIncrease = 1;
+		std::vector<index_t> heap;
+		std::vector<index_t> heapIndex;
+
+		std::vector<bool> model; // the model found
+		index_t decisions = 0; // the times of decision
+		index_t conflicts = 0; // the times of conflict
+		index_t learnedCount = 0; // the count of clauses learned
+		index_t learnedAlive = 0; // the count of clauses learned not removed
+		index_t backjumps = 0; // the times of jumping over a level
+		index_t restarts = 0; // the times of restart
+
+		static lit_t toLiteral(literal_t literal) { return literal > 0 ? (lit_t)(literal - 1) * 2 : (lit_t)(-literal - 1) * 2 + 1; }
+		signed char valueOf(lit_t literal) const;
+		index_t decisionLevel() const { return (index_t)trailLimits.size(); }
+
+		void enqueue(lit_t literal, index_t reason);
+		index_t addClause(const std::vector<lit_t>& literals, bool learned);
+		index_t propagate();
+		void analyze(index_t conflict, index_t& backLevel);
+		bool isRedundant(lit_t literal) const;
+		void backtrack(index_t level);
+		lit_t pickBranch();
+		void reduceLearned();
+		bool isLocked(index_t clause) const;
+
+		void bumpVariable(index_t variable);
+		void bumpClause(Clause& clause);
+		void heapUp(index_t i);
+		void heapDown(index_t i);
+		void heapInsert(index_t variable);
+		index_t heapPop();
+
+		static index_t luby(index_t i);
+
+	public:
+		SatSolver& load(index_t variableCount, const std::vector<literal_t>& clauses); // every clause ends with 0
+		char solve(const StopChecker& stop = StopChecker());
+		const std::vector<bool>& getModel() const; // model[v] for variable v, empty if not satisfiable
+
+		index_t getDecisions() const;
+		index_t getConflicts() const;
+		index_t getLearnedCount() const;
+		index_t getBackjumps() const;
+		index_t getRestarts() const;
+	};
+}
+
+#endif
@@ -0,0 +1,230 @@
+﻿// Code By YYYCZ
+
+#include "SudokuSelector.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+
+namespace YYYCZ {
+	// the names of engines in the file of model
+	static const char* const engineNames[SudokuSelector::EngineCount] = { "search", "learning", "sat", "annealing" };
+
+	/// <summary>
+	/// set the probes of estimating the nodes of search, a feature of the model
+	/// </summary>
+	/// <param name="count">count of probes, 0 for no estimate</param>
+	/// <returns>SudokuSelector</returns>
+	SudokuSelector& SudokuSelector::setProbes(index_t count)
+	{
+		probes = count;
+		return *this;
+	}
+
+	/// <summary>
+	/// get the probes of estimating the nodes
+	/// </summary>
+	/// <returns>count of probes, 0 for no estimate</returns>
+	SudokuSelector::index_t SudokuSelector::getProbes() const
+	{
+		return probes;
+	}
+
+	/// <summary>
+	/// judge if any engine has a model
+	/// </summary>
+	/// <returns>if calibrated</returns>
+	bool SudokuSelector::isCalibrated() const
+	{
+		for (char engine = 0; engine < (char)EngineCount; ++engine) {
+			if (hasModel(engine)) return true;
+		}
+		return false;
+	}
+
+	/// <summary>
+	/// judge if the engine has a model
+	/// </summary>
+	/// <param name="engine">the engine</param>
+	/// <returns>if has</returns>
+	bool SudokuSelector::hasModel(char engine) const
+	{
+		return engine >= 0 && engine < (char)EngineCount && weights[engine].size() == FeatureCount;
+	}
+
+	/// <summary>
+	/// get the vector of features for the model
+	/// </summary>
+	/// <param name="features">the features</param>
+	/// <param name="x">the vector, FeatureCount values</param>
+	void SudokuSelector::vectorOf(const Features& features, double* x)
+	{
+		x[0] = 1;
+		x[1] = std::log(std::max(1.0, features.length));
+		x[2] = features.givens;
+		x[3] = features.density;
+		x[4] = features.nodes;
+	}
+
+	/// <summary>
+	/// predict the cost of the engine
+	/// </summary>
+	/// <param name="engine">the engine</param>
+	/// <param name="features">the features of sudoku</param>
+	/// <returns>the log seconds, infinity if no model</returns>
+	double SudokuSelector::predict(char engine, const Features& features) const
+	{
+		if (!hasModel(engine)) return std::numeric_limits<double>::infinity();
+		double x[FeatureCount];
+		vectorOf(features, x);
+		double cost = 0;
+		for (index_t i = 0; i < FeatureCount; ++i) cost += weights[engine][i] * x[i];
+		return cost;
+	}
+
+	/// <summary>
+	/// choose the engine with least cost predicted. without any model the rules of size are used:
+	/// the local search for 49x49 and larger with few givens, the CDCL solver for 25x25 and larger,
+	/// the search learning the nogoods (with the hidden singles) for 16x16, and the search for 9x9 and smaller.
+	/// the plain search is only safe for the small ones, a nearly unsolvable 16x16 can take it minutes
+	/// </summary>
+	/// <param name="features">the features of sudoku</param>
+	/// <returns>the engine, Engine_X</returns>
+	char SudokuSelector::choose(const Features& features) const
+	{
+		if (!isCalibrated()) {
+			if (features.length >= 49 && features.givens < 0.4) return Engine_Annealing;
+			if (features.length >= 25) return Engine_Sat;
+			if (features.length > 9) return Engine_Learning;
+			return Engine_Search;
+		}
+
+		char best = Engine_Search;
+		double least = std::numeric_limits<double>::infinity();
+		for (char engine = 0; engine < (char)EngineCount; ++engine) {
+			const double cost = predict(engine, features);
+			if (cost < least) {
+				least = cost;
+				best = engine;
+			}
+		}
+		return best;
+	}
+
+	/// <summary>
+	/// fit the model of every engine measured, by the least squares of log seconds (a little ridge keeps it stable)
+	/// </summary>
+	/// <param name="samples">the sudokus solved by the engines</param>
+	/// <param name="penalty">the seconds of a sample not solved, such as some times of the limit</param>
+	void SudokuSelector::calibrate(const std::vector<Sample>& samples, double penalty)
+	{
+		constexpr index_t n = FeatureCount;
+		for (char engine = 0; engine < (char)EngineCount; ++engine) {
+			double a[n][n + 1] = {};
+			index_t count = 0;
+			for (auto& sample : samples) {
+				if (sample.seconds[engine] < 0) continue;
+				double x[n];
+				vectorOf(sample.features, x);
+				const double y = std::log(std::max(1e-6, sample.solved[engine] ? sample.seconds[engine] : penalty));
+				for (index_t i = 0; i < n; ++i) {
+					for (index_t j = 0; j < n; ++j) a[i][j] += x[i] * x[j];
+					a[i][n] += x[i] * y;
+				}
+				++count;
+			}
+			weights[engine].clear();
+			if (count == 0) continue;
+			for (index_t i = 0; i < n; ++i) a[i][i] += i ? 1e-3 * count : 1e-9;
+
+			// the gaussian elimination with partial pivot
+			for (index_t column = 0; column < n; ++column) {
+				index_t pivot = column;
+				for (index_t row = column + 1; row < n; ++row) {
+					if (std::fabs(a[row][column]) > std::fabs(a[pivot][column])) pivot = row;
+				}
+				for (index_t k = 0; k <= n; ++k) std::swap(a[column][k], a[pivot][k]);
+				if (std::fabs(a[column][column]) < 1e-12) continue;
+				for (index_t row = 0; row < n; ++row) {
+					if (row == column) continue;
+					const double factor = a[row][column] / a[column][column];
+					for (index_t k = column; k <= n; ++k) a[row][k] -= factor * a[column][k];
+				}
+			}
+			weights[engine].assign(n, 0);
+			for (index_t i = 0; i < n; ++i) {
+				if (std::fabs(a[i][i]) >= 1e-12) weights[engine][i] = a[i][n] / a[i][i];
+			}
+		}
+	}
+
+	/// <summary>
+	/// save the model as text:
+	/// "sudoku-selector 1", "probes N", then a line "ENGINE w0 w1 w2 w3 w4" for every engine calibrated
+	/// </summary>
+	/// <param name="file">the file</param>
+	/// <returns>if save successfully</returns>
+	bool SudokuSelector::save(const std::string& file) const
+	{
+		std::ofstream out(file, std::ios::trunc);
+		if (!out) return false;
+		out.precision(9);
+		out << "sudoku-selector 1\nprobes " << probes << '\n';
+		for (char engine = 0; engine < (char)EngineCount; ++engine) {
+			if (!hasModel(engine)) continue;
+			out << engineNames[(int)engine];
+			for (double weight : weights[engine]) out << ' ' << weight;
+			out << '\n';
+		}
+		out.flush();
+		return !out.fail();
+	}
+
+	/// <summary>
+	/// load the model saved
+	/// </summary>
+	/// <param name="file">the file</param>
+	/// <returns>the selector, null if bad</returns>
+	std::shared_ptr<const SudokuSelector> SudokuSelector::load(const std::string& file)
+	{
+		std::ifstream in(file);
+		std::string magic, key;
+		int version = 0;
+		if (!(in >> magic >> version) || magic != "sudoku-selector" || version != 1) return nullptr;
+
+		auto selector = std::make_shared<SudokuSelector>();
+		if (!(in >> key >> selector->probes) || key != "probes") return nullptr;
+		while (in >> key) {
+			const char engine = engineOf(key);
+			if (engine < 0) return nullptr;
+			selector->weights[engine].assign(FeatureCount, 0);
+			for (auto& weight : selector->weights[engine]) {
+				if (!(in >> weight)) return nullptr;
+			}
+		}
+		return selector;
+	}
+
+	/// <summary>
+	/// get the name of engine
+	/// </summary>
+	/// <param name="engine">the engine</param>
+	/// <returns>the name, "unknown" if bad</returns>
+	const char* SudokuSelector::nameOf(char engine)
+	{
+		return engine >= 0 && engine < (char)EngineCount ? engineNames[(int)engine] : "unknown";
+	}
+
+	/// <summary>
+	/// get the engine by name
+	/// </summary>
+	/// <param name="name">the name</param>
+	/// <returns>the engine, -1 if unknown</returns>
+	char SudokuSelector::engineOf(const std::string& name)
+	{
+		for (char engine = 0; engine < (char)EngineCount; ++engine) {
+			if (name == engineNames[(int)engine]) return engine;
+		}
+		return -1;
+	}
+}
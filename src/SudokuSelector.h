@@ -0,0 +1,66 @@
+﻿// Code By YYYCZ
+
+#ifndef __YYYCZ_SUDOKU_SELECTOR_H__
+#define __YYYCZ_SUDOKU_SELECTOR_H__
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace YYYCZ {
+	// choose the way to solve a sudoku by its features: the length, the ratio of givens,
+	// the density of candidates after the givens are filled, and the search tree estimated (if probes are set).
+	// the cost of every engine is a linear model of the log seconds, calibrated by solving a mix of sudokus,
+	// and saved as a small text file. the engines not calibrated are not chosen, and without any model the rules of size are used.
+	// THREAD SAFE (read only after made)
+	class SudokuSelector {
+	public:
+		using index_t = unsigned int;
+
+		static constexpr char Engine_Search = 0; // the search
+		static constexpr char Engine_Learning = 1; // the search learning the nogoods
+		static constexpr char Engine_Sat = 2; // the CDCL solver
+		static constexpr char Engine_Annealing = 3; // the local search
+		static constexpr index_t EngineCount = 4;
+		static constexpr index_t FeatureCount = 5; // the bias, log of length, givens, density and log of nodes
+
+		// the features of a sudoku
+		struct Features {
+			double length = 0; // the length of form
+			double givens = 0; // the ratio of places given
+			double density = 0; // the mean count of candidates of the blanks, divided by the length
+			double nodes = 0; // the log of nodes estimated, 0 if not estimated
+		};
+
+		// a sudoku solved by the engines, to calibrate
+		struct Sample {
+			Features features;
+			std::array<double, EngineCount> seconds{}; // the time of engines, negative if not measured
+			std::array<bool, EngineCount> solved{}; // false if stopped by the limit
+		};
+
+	private:
+		std::array<std::vector<double>, EngineCount> weights; // the model of every engine, empty if not calibrated
+		index_t probes = 0; // the probes of estimating the nodes, 0 for no estimate
+
+		static void vectorOf(const Features& features, double* x);
+
+	public:
+		SudokuSelector& setProbes(index_t count);
+		index_t getProbes() const;
+		bool isCalibrated() const; // any engine has a model
+		bool hasModel(char engine) const;
+
+		char choose(const Features& features) const; // the engine with least cost predicted, or by the rules of size
+		double predict(char engine, const Features& features) const; // the log seconds, infinity if no model
+		void calibrate(const std::vector<Sample>& samples, double penalty); // the time of a sample not solved is penalty
+
+		bool save(const std::string& file) const;
+		static std::shared_ptr<const SudokuSelector> load(const std::string& file); // null if bad
+		static const char* nameOf(char engine);
+		static char engineOf(const std::string& name); // -1 if unknown
+	};
+}
+
+#endif
@@ -0,0 +1,266 @@
+﻿// Code By YYYCZ
+
+#include "SudokuValidator.h"
+#include <algorithm>
+
+namespace YYYCZ {
+	/// <summary>
+	/// the lowest number of the bits
+	/// </summary>
+	/// <param name="mask">the bits, not 0</param>
+	/// <returns>the number</returns>
+	static SudokuValidator::save_t lowestNumber(SudokuValidator::mask_t mask)
+	{
+		SudokuValidator::save_t number = 1;
+		while (!((mask >> number) & 1)) ++number;
+		return number;
+	}
+
+	/// <summary>
+	/// set the layout of blocks, the forms of its size are validated with it
+	/// </summary>
+	/// <param name="geometry">the layout, null for the standard boxes of the size</param>
+	/// <returns>SudokuValidator</returns>
+	SudokuValidator& SudokuValidator::setGeometry(std::shared_ptr<const SudokuGeometry> geometry)
+	{
+		this->layout = std::move(geometry);
+		this->geometry.reset();
+		this->size = 0;
+		return *this;
+	}
+
+	/// <summary>
+	/// get the layout and the tables of units for the size, kept for the next sudoku of the same size
+	/// </summary>
+	/// <param name="formSize">the size of form</param>
+	/// <returns>false if no sudoku of the size</returns>
+	bool SudokuValidator::prepare(size_t formSize)
+	{
+		if (geometry && formSize == size) return true;
+		geometry = layout && layout->getSize() == formSize ? layout : SudokuGeometry::standard(formSize);
+		size = 0;
+		if (!geometry || formSize == 0) return false;
+
+		length = geometry->getLength();
+		size = geometry->getSize();
+		all = length < 64 ? ((1ull << length) - 1) << 1 : 0;
+		values.assign(size, 0);
+		candidates.assign(size, 0);
+		placed.assign(length < 64 ? 3 * length : 3 * length * (length + 1), 0);
+		pending.assign(3 * size + 1, 0);
+		once.assign(3 * length, 0);
+		twice.assign(3 * length, 0);
+		rowOf.resize(size);
+		columnOf.resize(size);
+		blockOf.resize(size);
+		for (index_t place = 0; place < size; ++place) {
+			rowOf[place] = place / length;
+			columnOf[place] = length + place % length;
+			blockOf[place] = 2 * length + geometry->blockOf(place);
+		}
+		unitPlaces.resize(3 * size);
+		for (index_t k = 0; k < length; ++k) {
+			for (index_t i = 0; i < length; ++i) {
+				unitPlaces[k * length + i] = k * length + i;
+				unitPlaces[(length + k) * length + i] = i * length + k;
+				unitPlaces[(2 * length + k) * length + i] = geometry->placeOf(k, i);
+			}
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// check the numbers given are in range and not repeated in a unit.
+	/// the numbers of units are bits, or a flag of every number for the length of 64 and larger
+	/// </summary>
+	/// <param name="form">the sudoku form</param>
+	/// <param name="report">the report</param>
+	/// <returns>false if bad</returns>
+	bool SudokuValidator::checkGivens(const save_t* form, Report& report)
+	{
+		std::fill(placed.begin(), placed.end(), 0);
+		const bool bits = length < 64;
+		for (index_t place = 0; place < size; ++place) {
+			const save_t number = form[place];
+			values[place] = number;
+			if (number == 0) continue;
+			if (number < 0 || number > (save_t)length) {
+				report.status = Status_BadNumber;
+				report.place = place;
+				report.number = number;
+				return false;
+			}
+
+			++report.givens;
+			const index_t units[3] = { rowOf[place], columnOf[place], blockOf[place] };
+			for (index_t unit : units) {
+				mask_t& seen = bits ? placed[unit] : placed[unit * (length + 1) + number];
+				const mask_t bit = bits ? 1ull << number : 1;
+				if (seen & bit) {
+					report.status = Status_Duplicate;
+					report.place = place;
+					report.number = number;
+					report.unit = unit;
+					return false;
+				}
+				seen |= bit;
+			}
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// fill a number, and erase it from the candidates of the peers.
+	/// the peers left one or no candidate are pending, so the naked singles go on without scanning all places
+	/// </summary>
+	/// <param name="place">the place</param>
+	/// <param name="number">the number</param>
+	/// <returns>false if the number is in a unit already</returns>
+	bool SudokuValidator::fill(index_t place, save_t number)
+	{
+		const mask_t bit = 1ull << number;
+		const index_t units[3] = { rowOf[place], columnOf[place], blockOf[place] };
+		if ((placed[units[0]] | placed[units[1]] | placed[units[2]]) & bit) return false;
+		values[place] = number;
+		candidates[place] = 0;
+		// no branch for the peers: every peer is written, and kept pending if it lost the number and has one or none left
+		mask_t* masks = candidates.data();
+		index_t* queue = pending.data();
+		for (index_t unit : units) {
+			placed[unit] |= bit;
+			const index_t* peers = &unitPlaces[unit * length];
+			for (index_t i = 0; i < length; ++i) {
+				const mask_t mask = masks[peers[i]], left = mask & ~bit;
+				masks[peers[i]] = left;
+				queue[pendingCount] = peers[i];
+				pendingCount += (mask != left) & ((left & (left - 1)) == 0);
+			}
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// fill the naked singles (a place with one number) and the hidden singles (a number with one place in a unit)
+	/// until no more, without search
+	/// </summary>
+	/// <param name="report">the report</param>
+	/// <returns>false if a contradiction is found</returns>
+	bool SudokuValidator::propagate(Report& report)
+	{
+		// the candidates of all places in one pass, no branch in the loop
+		for (index_t place = 0; place < size; ++place) {
+			const mask_t used = placed[rowOf[place]] | placed[columnOf[place]] | placed[blockOf[place]];
+			candidates[place] = values[place] ? 0 : all & ~used;
+		}
+		pendingCount = 0;
+		for (index_t place = 0; place < size; ++place) {
+			const mask_t mask = candidates[place];
+			pending[pendingCount] = place;
+			pendingCount += (values[place] == 0) & ((mask & (mask - 1)) == 0);
+		}
+
+		while (true) {
+			// the naked singles
+			while (pendingCount) {
+				const index_t place = pending[--pendingCount];
+				if (values[place]) continue;
+				const mask_t mask = candidates[place];
+				if (mask == 0 || !fill(place, lowestNumber(mask))) {
+					report.status = Status_NoCandidate;
+					report.place = place;
+					return false;
+				}
+				++report.filled;
+			}
+			if (report.givens + report.filled == size) return true;
+
+			// the hidden singles, the numbers of all units in one pass of places
+			std::fill(once.begin(), once.end(), 0);
+			std::fill(twice.begin(), twice.end(), 0);
+			for (index_t place = 0; place < size; ++place) {
+				const mask_t mask = candidates[place];
+				const index_t row = rowOf[place], column = columnOf[place], block = blockOf[place];
+				twice[row] |= once[row] & mask;
+				once[row] |= mask;
+				twice[column] |= once[column] & mask;
+				once[column] |= mask;
+				twice[block] |= once[block] & mask;
+				once[block] |= mask;
+			}
+			bool progress = false;
+			for (index_t unit = 0; unit < 3 * length; ++unit) {
+				if ((once[unit] | placed[unit]) != all) {
+					report.status = Status_NoPlace;
+					report.number = lowestNumber(all & ~(once[unit] | placed[unit]));
+					report.unit = unit;
+					return false;
+				}
+
+				// the singles are of the pass, a number filled since is skipped, and a number whose place is filled since has no place
+				const index_t* places = &unitPlaces[unit * length];
+				for (mask_t singles = once[unit] & ~twice[unit] & ~placed[unit]; singles; singles &= singles - 1) {
+					const save_t number = lowestNumber(singles);
+					if ((placed[unit] >> number) & 1) continue;
+					index_t i = 0;
+					while (i < length && !((candidates[places[i]] >> number) & 1)) ++i;
+					if (i == length) {
+						report.status = Status_NoPlace;
+						report.number = number;
+						report.unit = unit;
+						return false;
+					}
+					fill(places[i], number);
+					++report.filled;
+					progress = true;
+				}
+			}
+			if (!progress) return true;
+		}
+	}
+
+	/// <summary>
+	/// validate a sudoku
+	/// </summary>
+	/// <param name="form">the sudoku form</param>
+	/// <returns>the report</returns>
+	SudokuValidator::Report SudokuValidator::validate(const std::vector<save_t>& form)
+	{
+		return validate(form.data(), form.size());
+	}
+
+	/// <summary>
+	/// validate a sudoku: the givens, then the singles if the length is less than 64
+	/// </summary>
+	/// <param name="form">the sudoku form</param>
+	/// <param name="formSize">the size of form</param>
+	/// <returns>the report</returns>
+	SudokuValidator::Report SudokuValidator::validate(const save_t* form, size_t formSize)
+	{
+		Report report;
+		if (!prepare(formSize)) return report;
+		if (!checkGivens(form, report)) return report;
+		if (length < 64 && !propagate(report)) return report;
+		report.status = report.givens + report.filled == size ? Status_Solved : Status_Valid;
+		return report;
+	}
+
+	/// <summary>
+	/// get the form filled by the singles of last validating, the solution if solved
+	/// </summary>
+	/// <returns>the form</returns>
+	const std::vector<SudokuValidator::save_t>& SudokuValidator::getForm() const
+	{
+		return values;
+	}
+
+	/// <summary>
+	/// get the name of status
+	/// </summary>
+	/// <param name="status">the status</param>
+	/// <returns>the name</returns>
+	const char* SudokuValidator::nameOf(char status)
+	{
+		static const char* const names[] = { "valid", "solved", "bad-size", "bad-number", "duplicate", "no-candidate", "no-place" };
+		return status >= 0 && status <= Status_NoPlace ? names[(int)status] : "unknown";
+	}
+}
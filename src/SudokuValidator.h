@@ -0,0 +1,72 @@
+﻿// Code By YYYCZ
+
+#ifndef __YYYCZ_SUDOKU_VALIDATOR_H__
+#define __YYYCZ_SUDOKU_VALIDATOR_H__
+
+#include "SudokuGeometry.h"
+#include <memory>
+#include <vector>
+
+namespace YYYCZ {
+	// check a sudoku without search: the numbers given are in range and not repeated in a unit,
+	// then the naked and hidden singles are filled until no more, a place without number or a number without place is a contradiction.
+	// the candidates are bits in flat arrays, no set and no record, so the garbage is thrown away before the solvers.
+	// the length of 64 and larger only checks the givens. a valid sudoku may still have no solution.
+	// NOT THREAD SAFE (the buffers are reused, one validator a thread)
+	class SudokuValidator {
+	public:
+		using save_t = int;
+		using index_t = unsigned int;
+		using mask_t = unsigned long long;
+
+		static constexpr char Status_Valid = 0; // no contradiction found, need search
+		static constexpr char Status_Solved = 1; // filled by the singles only
+		static constexpr char Status_BadSize = 2; // the size is not a sudoku of the layout
+		static constexpr char Status_BadNumber = 3; // a number out of range
+		static constexpr char Status_Duplicate = 4; // a number given twice in a unit
+		static constexpr char Status_NoCandidate = 5; // a place can't be filled
+		static constexpr char Status_NoPlace = 6; // a number can't be put in a unit
+
+		// the result of validating
+		struct Report {
+			char status = Status_BadSize; // Status_X
+			index_t place = 0; // the place of contradiction, the second one of duplicate
+			save_t number = 0; // the number of contradiction, 0 if not a number
+			index_t unit = 0; // the unit of contradiction: rows, columns, then blocks
+			index_t givens = 0; // the count of numbers given
+			index_t filled = 0; // the count of places filled by the singles
+
+			bool isValid() const { return status == Status_Valid || status == Status_Solved; }
+		};
+
+	private:
+		std::shared_ptr<const SudokuGeometry> layout; // the layout set, null for the standard boxes
+		std::shared_ptr<const SudokuGeometry> geometry; // the layout of last size
+		index_t length = 0; // the length of form
+		index_t size = 0; // the size of form
+		mask_t all = 0; // the bits of all numbers
+		std::vector<save_t> values; // the numbers of places
+		std::vector<mask_t> candidates; // the numbers can be filled of places, 0 if filled
+		std::vector<mask_t> placed; // the numbers in every unit
+		std::vector<index_t> rowOf, columnOf, blockOf; // the units of every place
+		std::vector<index_t> unitPlaces; // the places of every unit, unit * length + i
+		std::vector<index_t> pending; // the places with one or no candidate, to fill or to fail
+		index_t pendingCount = 0; // the count of pending, every place is pending 3 times at most
+		std::vector<mask_t> once, twice; // the numbers can be filled in one place of every unit, and in more places
+
+		bool prepare(size_t formSize);
+		bool checkGivens(const save_t* form, Report& report);
+		bool fill(index_t place, save_t number);
+		bool propagate(Report& report);
+
+	public:
+		SudokuValidator& setGeometry(std::shared_ptr<const SudokuGeometry> geometry); // the layout of the forms of its size, null for the standard boxes
+
+		Report validate(const std::vector<save_t>& form);
+		Report validate(const save_t* form, size_t formSize);
+		const std::vector<save_t>& getForm() const; // the form filled by the singles of last validating
+		static const char* nameOf(char status);
+	};
+}
+
+#endif
@@ -0,0 +1,199 @@
+﻿// Code By YYYCZ
+
+#include "SudokuVariant.h"
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+
+namespace YYYCZ {
+	/// <summary>
+	/// set if the two diagonals are units
+	/// </summary>
+	/// <param name="flag">new flag</param>
+	/// <returns>SudokuVariant</returns>
+	SudokuVariant& SudokuVariant::setDiagonals(bool flag)
+	{
+		diagonals = flag;
+		return *this;
+	}
+
+	/// <summary>
+	/// set if no same number in a king's move
+	/// </summary>
+	/// <param name="flag">new flag</param>
+	/// <returns>SudokuVariant</returns>
+	SudokuVariant& SudokuVariant::setAntiKing(bool flag)
+	{
+		antiKing = flag;
+		return *this;
+	}
+
+	/// <summary>
+	/// set if no same number in a knight's move
+	/// </summary>
+	/// <param name="flag">new flag</param>
+	/// <returns>SudokuVariant</returns>
+	SudokuVariant& SudokuVariant::setAntiKnight(bool flag)
+	{
+		antiKnight = flag;
+		return *this;
+	}
+
+	/// <summary>
+	/// add a killer cage
+	/// </summary>
+	/// <param name="places">the (row, column) of places, from 0</param>
+	/// <param name="sum">the sum of numbers</param>
+	/// <returns>SudokuVariant</returns>
+	SudokuVariant& SudokuVariant::addCage(const std::vector<std::pair<index_t, index_t>>& places, index_t sum)
+	{
+		cages.emplace_back(places, sum);
+		return *this;
+	}
+
+	/// <summary>
+	/// parse the rules, one a line and "#" for comment:
+	/// "diagonals", "anti-king", "anti-knight", and "cage SUM r1c1 r1c2 ..." (the rows and columns from 1)
+	/// </summary>
+	/// <param name="text">the text of rules</param>
+	/// <returns>the rules, null if bad</returns>
+	std::shared_ptr<const SudokuVariant> SudokuVariant::parse(const std::string& text)
+	{
+		auto variant = std::make_shared<SudokuVariant>();
+		std::istringstream lines(text);
+		std::string line;
+		while (std::getline(lines, line)) {
+			line = line.substr(0, line.find('#'));
+			std::istringstream words(line);
+			std::string rule;
+			if (!(words >> rule)) continue;
+
+			if (rule == "diagonals") variant->setDiagonals(true);
+			else if (rule == "anti-king") variant->setAntiKing(true);
+			else if (rule == "anti-knight") variant->setAntiKnight(true);
+			else if (rule == "cage") {
+				long long sum = 0;
+				if (!(words >> sum) || sum <= 0) return nullptr;
+				std::vector<std::pair<index_t, index_t>> places;
+				std::string place;
+				while (words >> place) {
+					unsigned int row = 0, column = 0;
+					char r = 0, c = 0, rest = 0;
+					if (sscanf(place.c_str(), "%c%u%c%u%c", &r, &row, &c, &column, &rest) != 4
+						|| (r != 'r' && r != 'R') || (c != 'c' && c != 'C') || row == 0 || column == 0) return nullptr;
+					places.emplace_back(row - 1, column - 1);
+				}
+				if (places.empty()) return nullptr;
+				variant->addCage(places, (index_t)sum);
+			}
+			else return nullptr;
+		}
+		return variant;
+	}
+
+	/// <summary>
+	/// judge if any rule of peers: diagonals, anti-king, anti-knight or cages
+	/// </summary>
+	/// <returns>if has</returns>
+	bool SudokuVariant::hasPeers() const
+	{
+		return diagonals || antiKing || antiKnight || !cages.empty();
+	}
+
+	/// <summary>
+	/// judge if any killer cage
+	/// </summary>
+	/// <returns>if has</returns>
+	bool SudokuVariant::hasCages() const
+	{
+		return !cages.empty();
+	}
+
+	/// <summary>
+	/// make the tables for a length
+	/// </summary>
+	/// <param name="length">the length of form</param>
+	/// <param name="made">the tables</param>
+	void SudokuVariant::build(index_t length, Tables& made) const
+	{
+		const index_t size = length * length;
+		made.valid = true;
+		made.peers.assign(size, {});
+		made.cagesOf.assign(size, {});
+		made.cages.clear();
+
+		auto link = [&](index_t a, index_t b) {
+			if (a == b) return;
+			const index_t rowA = a / length, columnA = a % length, rowB = b / length, columnB = b % length;
+			if (rowA == rowB || columnA == columnB) return; // the units do it
+			made.peers[a].push_back(b);
+			made.peers[b].push_back(a);
+		};
+
+		if (diagonals) {
+			for (index_t i = 0; i < length; ++i) {
+				for (index_t j = i + 1; j < length; ++j) {
+					link(i * length + i, j * length + j);
+					link(i * length + (length - 1 - i), j * length + (length - 1 - j));
+				}
+			}
+		}
+
+		// the moves to the places after, every pair is linked once
+		std::vector<std::pair<int, int>> moves;
+		if (antiKing) moves.insert(moves.end(), { { 0, 1 }, { 1, -1 }, { 1, 0 }, { 1, 1 } });
+		if (antiKnight) moves.insert(moves.end(), { { 1, -2 }, { 1, 2 }, { 2, -1 }, { 2, 1 } });
+		for (index_t place = 0; place < size && !moves.empty(); ++place) {
+			const int row = (int)(place / length), column = (int)(place % length);
+			for (auto& move : moves) {
+				const int toRow = row + move.first, toColumn = column + move.second;
+				if (toRow < (int)length && toColumn >= 0 && toColumn < (int)length) link(place, toRow * length + toColumn);
+			}
+		}
+
+		// the numbers of a cage are different, and the cage can't be longer than the length
+		for (auto& rule : cages) {
+			Cage cage;
+			cage.sum = rule.second;
+			for (auto& coordinate : rule.first) {
+				if (coordinate.first >= length || coordinate.second >= length) made.valid = false;
+				else cage.places.push_back(coordinate.first * length + coordinate.second);
+			}
+			std::sort(cage.places.begin(), cage.places.end());
+			const index_t count = (index_t)cage.places.size();
+			if (std::unique(cage.places.begin(), cage.places.end()) != cage.places.end() || count > length || length >= 64
+				|| cage.sum < count * (count + 1) / 2 || cage.sum > count * (2 * length - count + 1) / 2) {
+				made.valid = false;
+				continue;
+			}
+			for (index_t a : cage.places) {
+				made.cagesOf[a].push_back((index_t)made.cages.size());
+				for (index_t b : cage.places) {
+					if (a < b) link(a, b);
+				}
+			}
+			made.cages.push_back(std::move(cage));
+		}
+
+		for (auto& peers : made.peers) {
+			std::sort(peers.begin(), peers.end());
+			peers.erase(std::unique(peers.begin(), peers.end()), peers.end());
+		}
+	}
+
+	/// <summary>
+	/// get the tables for a length, made once
+	/// </summary>
+	/// <param name="length">the length of form</param>
+	/// <returns>the tables</returns>
+	const SudokuVariant::Tables& SudokuVariant::tablesOf(index_t length) const
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		auto& made = tables[length];
+		if (!made) {
+			made.reset(new Tables());
+			build(length, *made);
+		}
+		return *made;
+	}
+}
@@ -0,0 +1,61 @@
+﻿// Code By YYYCZ
+
+#ifndef __YYYCZ_SUDOKU_VARIANT_H__
+#define __YYYCZ_SUDOKU_VARIANT_H__
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace YYYCZ {
+	// the rules besides the rows, columns and blocks:
+	// the two diagonals (X-sudoku), anti-king and anti-knight (a number is not a king's or knight's move from itself),
+	// and the killer cages (the numbers of a cage are different and their sum is given).
+	// the peers of the rules are made once for a length and shared by the solvers.
+	// THREAD SAFE (the rules are not changed after shared)
+	class SudokuVariant {
+	public:
+		using save_t = int;
+		using index_t = unsigned int;
+
+		// a killer cage
+		struct Cage {
+			std::vector<index_t> places; // the places, by index
+			index_t sum = 0; // the sum of numbers
+		};
+
+		// the rules for a length
+		struct Tables {
+			bool valid = false; // false if a cage is out of the form or can't be summed
+			std::vector<std::vector<index_t>> peers; // the places can't be the same number of every place, besides its units
+			std::vector<std::vector<index_t>> cagesOf; // the cages of every place
+			std::vector<Cage> cages; // the cages
+		};
+
+	private:
+		bool diagonals = false; // the two diagonals are units
+		bool antiKing = false; // no same number in a king's move
+		bool antiKnight = false; // no same number in a knight's move
+		std::vector<std::pair<std::vector<std::pair<index_t, index_t>>, index_t>> cages; // the (row, column) of places and the sum
+
+		mutable std::mutex lock; // lock of tables
+		mutable std::map<index_t, std::unique_ptr<Tables>> tables; // the tables made, by length
+
+		void build(index_t length, Tables& made) const;
+
+	public:
+		SudokuVariant& setDiagonals(bool flag);
+		SudokuVariant& setAntiKing(bool flag);
+		SudokuVariant& setAntiKnight(bool flag);
+		SudokuVariant& addCage(const std::vector<std::pair<index_t, index_t>>& places, index_t sum); // the (row, column) from 0
+		static std::shared_ptr<const SudokuVariant> parse(const std::string& text); // null if bad
+
+		bool hasPeers() const; // any rule of peers
+		bool hasCages() const;
+		const Tables& tablesOf(index_t length) const; // made once for a length
+	};
+}
+
+#endif
@@ -1,12 +1,16 @@
 ﻿#include "SudokuGame.h"
+#include "SudokuCommand.h"
 
-int main()
+int main(int argc, char* argv[])
 {
-	YYYCZ::SudokuGame game;
-	while (true) {
-		game.gameStart();
+	// command line tools
+	if (argc > 1) {
+		return YYYCZ::runCommand(argc, argv);
 	}
 
+	YYYCZ::SudokuGame game;
+	while (game.gameStart());
+
 	return 0;
 }
 
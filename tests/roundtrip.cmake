@@ -0,0 +1,9 @@
+# solve the sudoku of INPUT by SUDOKU, the solution must be the same as EXPECTED (in the same alphabet)
+execute_process(COMMAND ${SUDOKU} solve ${INPUT} ${OUTPUT} --threads 1 RESULT_VARIABLE result ERROR_QUIET)
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "solve failed: ${result}")
+endif()
+execute_process(COMMAND ${CMAKE_COMMAND} -E compare_files ${OUTPUT} ${EXPECTED} RESULT_VARIABLE different)
+if(different)
+  message(FATAL_ERROR "${OUTPUT} is not the same as ${EXPECTED}")
+endif()